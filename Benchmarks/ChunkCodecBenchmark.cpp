@@ -0,0 +1,147 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+// Chunk file codec throughput on engine free copies of typical chunks
+
+#include "VoxelCore/ChunkCodec.h"
+#include "FastNoiseLite.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+namespace
+{
+	using VoxelCore::FRunBlock;
+	const FRunBlock Air;
+
+	enum class EFixture
+	{
+		Empty,
+		Full,
+		Terrain,
+		Random
+	};
+
+	// Blocks in chunk data order, X first and Z last
+	std::vector<FRunBlock> MakeChunk(const EFixture InFixture, const int32_t InSize)
+	{
+		std::vector<FRunBlock> blocks(static_cast<size_t>(InSize) * InSize * InSize, Air);
+		FastNoiseLite noise(1337);
+		noise.SetFractalType(FastNoiseLite::FractalType_FBm);
+		std::mt19937 random(1337);
+		for (int32_t Z = 0, Index = 0; Z < InSize; ++Z)
+		{
+			for (int32_t Y = 0; Y < InSize; ++Y)
+			{
+				for (int32_t X = 0; X < InSize; ++X, ++Index)
+				{
+					FRunBlock& block = blocks[Index];
+					switch (InFixture)
+					{
+					case EFixture::Empty:
+						break;
+					case EFixture::Full:
+						block = {1, true};
+						break;
+					case EFixture::Terrain:
+					{
+						// Stone, dirt and a visible grass top like the layers of the generators
+						const int32_t Height = static_cast<int32_t>((noise.GetNoise(static_cast<float>(X), static_cast<float>(Y)) / 2.0f + 0.5f) * InSize);
+						if(Z < Height - 3) block = {1, false};
+						else if(Z < Height) block = {2, false};
+						else if(Z == Height) block = {3, true};
+						break;
+					}
+					case EFixture::Random:
+						if(random() % 2 == 0) block = {static_cast<uint8_t>(random() % 3), true};
+						break;
+					}
+				}
+			}
+		}
+		return blocks;
+	}
+
+	std::vector<uint8_t> Encode(const std::vector<FRunBlock>& InBlocks, const int32_t InSize)
+	{
+		VoxelCore::FChunkEncoder encoder(InSize, InSize, InSize);
+		for (const FRunBlock& block : InBlocks)
+		{
+			encoder.Add(block);
+		}
+		return encoder.Finish();
+	}
+
+	void BM_EncodeChunk(benchmark::State& State)
+	{
+		const int32_t Size = static_cast<int32_t>(State.range(1));
+		const std::vector<FRunBlock> blocks = MakeChunk(static_cast<EFixture>(State.range(0)), Size);
+		size_t Bytes = 0;
+		for (auto _ : State)
+		{
+			std::vector<uint8_t> data = Encode(blocks, Size);
+			Bytes = data.size();
+			benchmark::DoNotOptimize(data.data());
+		}
+		State.SetItemsProcessed(static_cast<int64_t>(State.iterations() * blocks.size()));
+		State.counters["bytes"] = static_cast<double>(Bytes);
+	}
+
+	void BM_DecodeChunk(benchmark::State& State)
+	{
+		const int32_t Size = static_cast<int32_t>(State.range(1));
+		const std::vector<FRunBlock> blocks = MakeChunk(static_cast<EFixture>(State.range(0)), Size);
+		const std::vector<uint8_t> data = Encode(blocks, Size);
+
+		int32_t ChunkSize[3];
+		std::vector<VoxelCore::FBlockRun> runs;
+		if(!VoxelCore::DecodeChunk(data.data(), data.size(), ChunkSize, runs))
+		{
+			State.SkipWithError("encoded chunk doesn't decode");
+			return;
+		}
+		size_t Index = 0;
+		for (const VoxelCore::FBlockRun& run : runs)
+		{
+			for (uint32_t Count = 0; Count < run.Count; ++Count, ++Index)
+			{
+				if(Index >= blocks.size() || blocks[Index] != run.Block)
+				{
+					State.SkipWithError("decoded chunk differs");
+					return;
+				}
+			}
+		}
+		// A file cut off after a whole run has to be rejected as well
+		if(runs.size() > 1 && VoxelCore::DecodeChunk(data.data(), data.size() - 9, ChunkSize, runs))
+		{
+			State.SkipWithError("truncated chunk decodes");
+			return;
+		}
+
+		for (auto _ : State)
+		{
+			runs.clear();
+			benchmark::DoNotOptimize(VoxelCore::DecodeChunk(data.data(), data.size(), ChunkSize, runs));
+			benchmark::DoNotOptimize(runs.data());
+		}
+		// Decoding is per run, blocks are only expanded by the caller
+		State.SetItemsProcessed(static_cast<int64_t>(State.iterations() * runs.size()));
+		State.counters["runs"] = static_cast<double>(runs.size());
+	}
+
+	void ChunkArgs(benchmark::internal::Benchmark* Benchmark)
+	{
+		Benchmark->ArgNames({"fixture", "size"});
+		for (const EFixture Fixture : {EFixture::Empty, EFixture::Full, EFixture::Terrain, EFixture::Random})
+		{
+			for (const int64_t Size : {16, 32})
+			{
+				Benchmark->Args({static_cast<int64_t>(Fixture), Size});
+			}
+		}
+	}
+}
+
+BENCHMARK(BM_EncodeChunk)->Apply(ChunkArgs);
+BENCHMARK(BM_DecodeChunk)->Apply(ChunkArgs);
+
+BENCHMARK_MAIN();
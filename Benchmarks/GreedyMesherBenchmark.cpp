@@ -0,0 +1,205 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+// Greedy mesher throughput on engine free copies of typical chunks
+
+#include "VoxelCore/GreedyMesher.h"
+#include "FastNoiseLite.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+namespace
+{
+	using VoxelCore::FRunBlock;
+	const FRunBlock Air;
+	constexpr uint32_t BlockTypeCount = 3;
+
+	enum class EFixture
+	{
+		Empty,
+		Full,
+		FullWithNeighbors,
+		Checkerboard,
+		Terrain,
+		Random
+	};
+
+	struct FChunk
+	{
+		int32_t Size = 0;
+		std::vector<FRunBlock> Blocks;
+		std::vector<uint8_t> Light;
+		// Fills the border with the same blocks, so faces on the chunk border are culled
+		bool bWithNeighbors = false;
+
+		const FRunBlock& GetBlock(const int32_t X, const int32_t Y, const int32_t Z) const
+		{
+			if(X < 0 || X >= Size || Y < 0 || Y >= Size || Z < 0 || Z >= Size) return bWithNeighbors ? Blocks[0] : Air;
+			return Blocks[(static_cast<size_t>(Z) * Size + Y) * Size + X];
+		}
+	};
+
+	FChunk MakeChunk(const EFixture InFixture, const int32_t InSize)
+	{
+		FChunk chunk;
+		chunk.Size = InSize;
+		chunk.Blocks.assign(static_cast<size_t>(InSize) * InSize * InSize, Air);
+		// Light varies a little, so it splits quads like baked light does
+		chunk.Light.assign(chunk.Blocks.size(), 0xF0);
+		chunk.bWithNeighbors = InFixture == EFixture::FullWithNeighbors;
+		FastNoiseLite noise(1337);
+		noise.SetFractalType(FastNoiseLite::FractalType_FBm);
+		std::mt19937 random(1337);
+		for (int32_t Z = 0, Index = 0; Z < InSize; ++Z)
+		{
+			for (int32_t Y = 0; Y < InSize; ++Y)
+			{
+				for (int32_t X = 0; X < InSize; ++X, ++Index)
+				{
+					FRunBlock& block = chunk.Blocks[Index];
+					switch (InFixture)
+					{
+					case EFixture::Empty:
+						break;
+					case EFixture::Full:
+					case EFixture::FullWithNeighbors:
+						block = {0, true};
+						break;
+					case EFixture::Checkerboard:
+						if((X + Y + Z) % 2 == 0) block = {0, true};
+						break;
+					case EFixture::Terrain:
+					{
+						// Stone, dirt and grass on top like the layers of the generators
+						const int32_t Height = static_cast<int32_t>((noise.GetNoise(static_cast<float>(X), static_cast<float>(Y)) / 2.0f + 0.5f) * InSize);
+						if(Z < Height - 3) block = {2, true};
+						else if(Z < Height) block = {0, true};
+						else if(Z == Height) block = {1, true};
+						else if(Z > Height + 2) chunk.Light[Index] = 0xF0 - 0x10 * static_cast<uint8_t>(std::min(Z - Height, 8));
+						break;
+					}
+					case EFixture::Random:
+						if(random() % 2 == 0) block = {static_cast<uint8_t>(random() % BlockTypeCount), true};
+						break;
+					}
+				}
+			}
+		}
+		return chunk;
+	}
+
+	VoxelCore::FMesherInput MakeInput(const FChunk& InChunk)
+	{
+		VoxelCore::FMesherInput Input;
+		Input.Size[0] = Input.Size[1] = Input.Size[2] = InChunk.Size;
+		Input.Blocks = InChunk.Blocks.data();
+		Input.Light = InChunk.Light.data();
+		Input.GetBorder = [&InChunk](const int32_t X, const int32_t Y, const int32_t Z, FRunBlock& OutBlock, uint8_t& OutLight)
+		{
+			OutBlock = InChunk.GetBlock(X, Y, Z);
+			OutLight = 0xF0;
+		};
+		Input.BlockTypeCount = BlockTypeCount;
+		Input.bAmbientOcclusion = true;
+		return Input;
+	}
+
+	// Every side of a meshed block facing air has to be covered by exactly one quad of its block, nothing else may be
+	const char* CheckMesh(const FChunk& InChunk, const VoxelCore::FSideMesh InMeshes[VoxelCore::MeshSideCount])
+	{
+		static const int32_t Normals[VoxelCore::MeshSideCount][3] = {{0, 0, 1}, {0, 0, -1}, {0, 1, 0}, {0, -1, 0}, {1, 0, 0}, {-1, 0, 0}};
+		const int32_t Size = InChunk.Size;
+		std::vector<uint8_t> Covered(InChunk.Blocks.size() * VoxelCore::MeshSideCount, 0);
+		for (int32_t Side = 0; Side < VoxelCore::MeshSideCount; ++Side)
+		{
+			const VoxelCore::FSideMesh& Mesh = InMeshes[Side];
+			if(Mesh.Positions.size() != Mesh.Quads.size() * 12 || Mesh.VertexOcclusion.size() != Mesh.Quads.size() * 4 || Mesh.Indices.size() != Mesh.Quads.size() * 6)
+			{
+				return "vertices and indices are not whole quads";
+			}
+			for (const VoxelCore::FMeshQuad& Quad : Mesh.Quads)
+			{
+				for (int32_t Z = Quad.Min[2]; Z <= Quad.Max[2]; ++Z)
+				{
+					for (int32_t Y = Quad.Min[1]; Y <= Quad.Max[1]; ++Y)
+					{
+						for (int32_t X = Quad.Min[0]; X <= Quad.Max[0]; ++X)
+						{
+							if(InChunk.GetBlock(X, Y, Z) != Quad.Block) return "quad covers another block";
+							if(uint8_t& bIsCovered = Covered[((static_cast<size_t>(Z) * Size + Y) * Size + X) * VoxelCore::MeshSideCount + Side]; !bIsCovered)
+							{
+								bIsCovered = 1;
+							}
+							else
+							{
+								return "face covered twice";
+							}
+						}
+					}
+				}
+			}
+		}
+		for (int32_t Z = 0; Z < Size; ++Z)
+		{
+			for (int32_t Y = 0; Y < Size; ++Y)
+			{
+				for (int32_t X = 0; X < Size; ++X)
+				{
+					const FRunBlock& Block = InChunk.GetBlock(X, Y, Z);
+					const bool bIsMeshed = Block != Air && Block.BlockTypeId < BlockTypeCount;
+					for (int32_t Side = 0; Side < VoxelCore::MeshSideCount; ++Side)
+					{
+						const int32_t* Normal = Normals[Side];
+						const bool bIsVisible = bIsMeshed && InChunk.GetBlock(X + Normal[0], Y + Normal[1], Z + Normal[2]) == Air;
+						if(bIsVisible != (Covered[((static_cast<size_t>(Z) * Size + Y) * Size + X) * VoxelCore::MeshSideCount + Side] != 0))
+						{
+							return bIsVisible ? "visible face not covered" : "hidden face covered";
+						}
+					}
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	void BM_GreedyMesh(benchmark::State& State)
+	{
+		const FChunk chunk = MakeChunk(static_cast<EFixture>(State.range(0)), static_cast<int32_t>(State.range(1)));
+		const VoxelCore::FMesherInput Input = MakeInput(chunk);
+		VoxelCore::FSideMesh Meshes[VoxelCore::MeshSideCount];
+		VoxelCore::GreedyMesh(Input, Meshes);
+		if(const char* Error = CheckMesh(chunk, Meshes))
+		{
+			State.SkipWithError(Error);
+			return;
+		}
+		size_t Quads = 0;
+		for (const VoxelCore::FSideMesh& Mesh : Meshes)
+		{
+			Quads += Mesh.Quads.size();
+		}
+
+		for (auto _ : State)
+		{
+			VoxelCore::GreedyMesh(Input, Meshes);
+			benchmark::DoNotOptimize(Meshes[0].Positions.data());
+		}
+		State.SetItemsProcessed(static_cast<int64_t>(State.iterations() * chunk.Blocks.size()));
+		State.counters["quads"] = static_cast<double>(Quads);
+	}
+
+	void MeshArgs(benchmark::internal::Benchmark* Benchmark)
+	{
+		Benchmark->ArgNames({"fixture", "size"});
+		for (const EFixture Fixture : {EFixture::Empty, EFixture::Full, EFixture::FullWithNeighbors, EFixture::Checkerboard, EFixture::Terrain, EFixture::Random})
+		{
+			for (const int64_t Size : {16, 32})
+			{
+				Benchmark->Args({static_cast<int64_t>(Fixture), Size});
+			}
+		}
+	}
+}
+
+BENCHMARK(BM_GreedyMesh)->Apply(MeshArgs);
+
+BENCHMARK_MAIN();
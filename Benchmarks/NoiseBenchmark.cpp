@@ -0,0 +1,96 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+// FastNoiseLite per point against the batched grids the generators use, samples/s is items_per_second
+
+#include "FastNoiseLite.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace
+{
+	// The fractal the generators default to
+	FastNoiseLite MakeNoise()
+	{
+		FastNoiseLite noise(1337);
+		noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+		noise.SetFractalType(FastNoiseLite::FractalType_FBm);
+		noise.SetFractalOctaves(3);
+		return noise;
+	}
+
+	void BM_NoisePoint2D(benchmark::State& State)
+	{
+		FastNoiseLite noise = MakeNoise();
+		const int32_t Size = static_cast<int32_t>(State.range(0));
+		std::vector<float> values(static_cast<size_t>(Size) * Size);
+		for (auto _ : State)
+		{
+			for (int32_t Y = 0, Index = 0; Y < Size; ++Y)
+			{
+				for (int32_t X = 0; X < Size; ++X)
+				{
+					values[Index++] = noise.GetNoise(static_cast<float>(X), static_cast<float>(Y));
+				}
+			}
+			benchmark::DoNotOptimize(values.data());
+		}
+		State.SetItemsProcessed(static_cast<int64_t>(State.iterations() * values.size()));
+	}
+
+	void BM_NoiseGrid2D(benchmark::State& State)
+	{
+		FastNoiseLite noise = MakeNoise();
+		const int32_t Size = static_cast<int32_t>(State.range(0));
+		std::vector<float> values(static_cast<size_t>(Size) * Size);
+		for (auto _ : State)
+		{
+			noise.GetNoiseGrid2D(values.data(), 0, 0, Size, Size);
+			benchmark::DoNotOptimize(values.data());
+		}
+		State.SetItemsProcessed(static_cast<int64_t>(State.iterations() * values.size()));
+	}
+
+	void BM_NoisePoint3D(benchmark::State& State)
+	{
+		FastNoiseLite noise = MakeNoise();
+		const int32_t Size = static_cast<int32_t>(State.range(0));
+		std::vector<float> values(static_cast<size_t>(Size) * Size * Size);
+		for (auto _ : State)
+		{
+			for (int32_t Z = 0, Index = 0; Z < Size; ++Z)
+			{
+				for (int32_t Y = 0; Y < Size; ++Y)
+				{
+					for (int32_t X = 0; X < Size; ++X)
+					{
+						values[Index++] = noise.GetNoise(static_cast<float>(X), static_cast<float>(Y), static_cast<float>(Z));
+					}
+				}
+			}
+			benchmark::DoNotOptimize(values.data());
+		}
+		State.SetItemsProcessed(static_cast<int64_t>(State.iterations() * values.size()));
+	}
+
+	// Every thread fills its own grid with its own copy of the noise, like the generators on the worker threads
+	void BM_NoiseGrid3D(benchmark::State& State)
+	{
+		FastNoiseLite noise = MakeNoise();
+		const int32_t Size = static_cast<int32_t>(State.range(0));
+		const float StartZ = static_cast<float>(State.thread_index() * Size);
+		std::vector<float> values(static_cast<size_t>(Size) * Size * Size);
+		for (auto _ : State)
+		{
+			noise.GetNoiseGrid3D(values.data(), 0, 0, StartZ, Size, Size, Size);
+			benchmark::DoNotOptimize(values.data());
+		}
+		State.SetItemsProcessed(static_cast<int64_t>(State.iterations() * values.size()));
+	}
+}
+
+BENCHMARK(BM_NoisePoint2D)->Arg(16)->Arg(64);
+BENCHMARK(BM_NoiseGrid2D)->Arg(16)->Arg(64);
+BENCHMARK(BM_NoisePoint3D)->Arg(16)->Arg(32);
+BENCHMARK(BM_NoiseGrid3D)->Arg(16)->Arg(32)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,87 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Mesh/ChunkCollisionBuilder.h"
+#include "Globals.h"
+
+DECLARE_CYCLE_STAT(TEXT("Build chunk collision boxes"), STAT_BuildCollisionBoxes, STATGROUP_CubicWorld);
+
+bool FChunkCollisionBuilder::IsSolid(const FBlock& InBlock, const FWorldConfig& InWorldConfig)
+{
+	return InBlock != Air && InWorldConfig.BlockTypes.IsValidIndex(InBlock.BlockTypeID) && InWorldConfig.BlockTypes[InBlock.BlockTypeID].bIsSolid;
+}
+
+void FChunkCollisionBuilder::BuildBoxes(const TChunkData& InBlocks, const FWorldConfig& InWorldConfig, TArray<FCollisionBox>& OutBoxes)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BuildCollisionBoxes);
+	const FIntVector Size = InBlocks.GetChunkSize();
+	auto Index = [&](const int32 X, const int32 Y, const int32 Z)
+	{
+		return Z * Size.X * Size.Y + Y * Size.X + X;
+	};
+
+	// Blocks that are solid and not yet part of a box
+	TBitArray<> Open(false, Size.X * Size.Y * Size.Z);
+	int32 BlockIndex = 0;
+	for (const FBlock& Block : InBlocks)
+	{
+		if(BlockIndex >= Open.Num()) break;
+		Open[BlockIndex++] = IsSolid(Block, InWorldConfig);
+	}
+
+	for (int Z = 0; Z < Size.Z; ++Z)
+	{
+		for (int Y = 0; Y < Size.Y; ++Y)
+		{
+			for (int X = 0; X < Size.X; ++X)
+			{
+				if(!Open[Index(X, Y, Z)]) continue;
+
+				int32 EndX = X;
+				while (EndX + 1 < Size.X && Open[Index(EndX + 1, Y, Z)])
+				{
+					EndX++;
+				}
+
+				auto IsRowOpen = [&](const int32 InY, const int32 InZ)
+				{
+					for (int Xs = X; Xs <= EndX; ++Xs)
+					{
+						if(!Open[Index(Xs, InY, InZ)]) return false;
+					}
+					return true;
+				};
+
+				int32 EndY = Y;
+				while (EndY + 1 < Size.Y && IsRowOpen(EndY + 1, Z))
+				{
+					EndY++;
+				}
+
+				int32 EndZ = Z;
+				while (EndZ + 1 < Size.Z)
+				{
+					bool bIsLayerOpen = true;
+					for (int Ys = Y; Ys <= EndY && bIsLayerOpen; ++Ys)
+					{
+						bIsLayerOpen = IsRowOpen(Ys, EndZ + 1);
+					}
+					if(!bIsLayerOpen) break;
+					EndZ++;
+				}
+
+				for (int Zs = Z; Zs <= EndZ; ++Zs)
+				{
+					for (int Ys = Y; Ys <= EndY; ++Ys)
+					{
+						for (int Xs = X; Xs <= EndX; ++Xs)
+						{
+							Open[Index(Xs, Ys, Zs)] = false;
+						}
+					}
+				}
+				OutBoxes.Add({FIntVector(X, Y, Z), FIntVector(EndX, EndY, EndZ)});
+			}
+		}
+	}
+}
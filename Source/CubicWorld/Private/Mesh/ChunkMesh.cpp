@@ -41,6 +41,10 @@ void AChunkMesh::GenerateMesh()
 {
 	if(RuntimeMeshComponent != nullptr)
 	{
+		if(ChunkProvider != nullptr)
+		{
+			ChunkProvider->MarkMeshDirty();
+		}
 		RuntimeMeshComponent->GetRuntimeMesh()->MarkAllLODsDirty();
 	} else
 	{
@@ -56,14 +60,22 @@ void AChunkMesh::GenerateMesh()
 			ChunkProvider = NewObject<URuntimeMeshProviderChunk>();
 		}
 
-		if(ChunkProvider != nullptr)
+		if(ChunkProvider != nullptr && Chunk->GetChunkConfig().WorldConfig.bUseSimpleCollision)
+		{
+			ChunkProvider->SetChunk(Chunk);
+			RMC->Initialize(ChunkProvider);
+		}
+		else if(ChunkProvider != nullptr)
 		{
 			ChunkProvider->SetChunk(Chunk);
 	
 			URuntimeMeshProviderCollision* ChunkCollisionProvider = NewObject<URuntimeMeshProviderCollision>();
 			ChunkCollisionProvider->SetChildProvider(ChunkProvider);
 			ChunkCollisionProvider->SetRenderableLODForCollision(0);
-			ChunkCollisionProvider->SetRenderableSectionAffectsCollision(0, true);
+			for (int32 SectionId = 0; SectionId < ChunkProvider->GetSectionCount(); ++SectionId)
+			{
+				ChunkCollisionProvider->SetRenderableSectionAffectsCollision(SectionId, true);
+			}
 		
 			FRuntimeMeshCollisionSettings CollisionSettings;
 			CollisionSettings.bUseComplexAsSimple = true;
@@ -75,6 +87,22 @@ void AChunkMesh::GenerateMesh()
 	
 }
 
+void AChunkMesh::UpdateSectionVisibility(const FVector& InViewLocation) const
+{
+	if(ChunkProvider != nullptr)
+	{
+		ChunkProvider->UpdateSideVisibility(InViewLocation - GetActorLocation());
+	}
+}
+
+void AChunkMesh::SetChunkCollisionEnabled(const bool bInCollisionEnabled) const
+{
+	if(ChunkProvider != nullptr)
+	{
+		ChunkProvider->SetCollisionEnabled(bInCollisionEnabled);
+	}
+}
+
 void AChunkMesh::ShowDebugLines(const bool ChunkDebugLines, const bool BlocksDebugLines, const bool GridDebugLines) const
 {
 	const FWorldConfig& WorldConfig = Chunk->GetChunkConfig().WorldConfig;
@@ -3,6 +3,8 @@
 
 #include "Mesh/RuntimeMeshProviderChunk.h"
 #include "Globals.h"
+#include "Mesh/ChunkCollisionBuilder.h"
+#include "VoxelCore/GreedyMesher.h"
 
 DECLARE_CYCLE_STAT(TEXT("Generate chunk mesh"), STAT_GenerateMesh, STATGROUP_CubicWorld);
 DECLARE_CYCLE_STAT(TEXT("Generate chunk collsion mesh"), STAT_GenerateCollisionMesh, STATGROUP_CubicWorld);
@@ -10,6 +12,15 @@ DECLARE_CYCLE_STAT(TEXT("Generate chunk collsion mesh"), STAT_GenerateCollisionM
 DECLARE_CYCLE_STAT(TEXT("Generate tile mesh"), STAT_GenerateTileMesh, STATGROUP_CubicWorld);
 DECLARE_CYCLE_STAT(TEXT("Generate tile collsion mesh"), STAT_GenerateTileCollisionMesh, STATGROUP_CubicWorld);
 
+namespace
+{
+	// Tangent of each side in the order of FSides
+	const FVector SideTangents[FSides::Num] = {
+		{1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}
+	};
+	const FVector2f QuadUVs[4] = {FVector2f(0, 1), FVector2f(0), FVector2f(1, 0), FVector2f(1)};
+}
+
 
 void URuntimeMeshProviderChunk::Initialize()
 {
@@ -37,20 +48,11 @@ void URuntimeMeshProviderChunk::Initialize()
 		Properties.bIsVisible = true;
 		Properties.MaterialSlot = 0;
 		Properties.UpdateFrequency = ERuntimeMeshUpdateFrequency::Infrequent;
-		CreateSection(LODIndex, 0, Properties);
+		for (int32 SectionId = 0; SectionId < GetSectionCount(); ++SectionId)
+		{
+			CreateSection(LODIndex, SectionId, Properties);
+		}
 	}
-	
-	BlockVertices = {
-		FVector(0.0f,	 0.0f,		0.0f),												// 0 Left	Back	Bottom
-		FVector(WorldConfig.BlockSize.X, 0.0f,		0.0f),									// 1 Right	Back	Bottom
-		FVector(WorldConfig.BlockSize.X, WorldConfig.BlockSize.Y,	0.0f),						// 2 Right	Front	Bottom
-		FVector(0.0f,	 WorldConfig.BlockSize.Y,	0.0f),									// 3 Left	Front	Bottom
-		
-		FVector(0.0f,	 0.0f,		WorldConfig.BlockSize.Z),								// 4 Left	Back	Top
-		FVector(WorldConfig.BlockSize.X, 0.0f,		WorldConfig.BlockSize.Z),					// 5 Right	Back	Top
-		FVector(WorldConfig.BlockSize.X, WorldConfig.BlockSize.Y,	WorldConfig.BlockSize.Z),		// 6 Right	Front	Top
-		FVector(0.0f,	 WorldConfig.BlockSize.Y,	WorldConfig.BlockSize.Z),					// 7 Left	Front	Top
-	};
 }
 
 FBoxSphereBounds URuntimeMeshProviderChunk::GetBounds()
@@ -61,15 +63,38 @@ FBoxSphereBounds URuntimeMeshProviderChunk::GetBounds()
 
 bool URuntimeMeshProviderChunk::GetSectionMeshForLOD(const int32 LODIndex, const int32 SectionId, FRuntimeMeshRenderableMeshData& MeshData)
 {
-	check(SectionId == 0);
+	check(SectionId >= 0 && SectionId < GetSectionCount());
 	SCOPE_CYCLE_COUNTER(STAT_GenerateMesh);
 	SCOPED_NAMED_EVENT(URuntimeMeshProviderChunk_GenerateMesh, FColor::Green);
 	FScopeLock Lock(&PropertySyncRoot);
 	
 	if(Chunk == nullptr) return false;
-	MeshData.TexCoords = FRuntimeMeshVertexTexCoordStream(2);
 
-	GreedyMesh(MeshData);
+	if(bSplitSectionsByDirection)
+	{
+		if(CachedMeshRevision != MeshRevision || !PendingSideMeshData[SectionId])
+		{
+			CachedSideMeshData.Reset();
+			TArray<FRuntimeMeshRenderableMeshData*> SideMeshData;
+			for (int32 SideIndex = 0; SideIndex < FSides::Num; ++SideIndex)
+			{
+				FRuntimeMeshRenderableMeshData& SideMesh = CachedSideMeshData.AddDefaulted_GetRef();
+				SideMesh.TexCoords = FRuntimeMeshVertexTexCoordStream(2);
+			}
+			for (FRuntimeMeshRenderableMeshData& SideMesh : CachedSideMeshData)
+			{
+				SideMeshData.Add(&SideMesh);
+			}
+			GreedyMesh(SideMeshData);
+			PendingSideMeshData.Init(true, FSides::Num);
+			CachedMeshRevision = MeshRevision;
+		}
+		MeshData = MoveTemp(CachedSideMeshData[SectionId]);
+		PendingSideMeshData[SectionId] = false;
+	} else
+	{
+		GetMeshData(MeshData);
+	}
 
 	if(MeshData.Triangles.Num() <= 0 || MeshData.Positions.Num() <= 0)
 	{
@@ -89,26 +114,68 @@ uint32 URuntimeMeshProviderChunk::AddVertex(FRuntimeMeshRenderableMeshData& Mesh
 	return index;
 }
 
-void URuntimeMeshProviderChunk::AddQuad(FRuntimeMeshRenderableMeshData& MeshData, const FVector& Vertex1,
-	const FVector& Vertex2, const FVector& Vertex3, const FVector& Vertex4,
+void URuntimeMeshProviderChunk::AddQuad(FRuntimeMeshRenderableMeshData& MeshData, const VoxelCore::FSideMesh& InSideMesh, const int32 InQuadIndex,
+	const FVector& InBlockSize, const FVector& InOffset,
 	const FVector& Normal, const FVector& Tangent,
-	const uint32 TextureId, const FVector2f& UVMultiplication, const FColor& Color)
+	const uint32 TextureId, const FVector2f& UVMultiplication, const FColor& Color,
+	const float AmbientOcclusionStrength)
 {
-	const int32 idx0 = AddVertex(MeshData, Vertex1, Normal, Tangent, FVector2f(0, 1)*UVMultiplication,	FVector2f(TextureId, 0), Color);
-	const int32 idx1 = AddVertex(MeshData, Vertex2, Normal, Tangent, FVector2f(0)*UVMultiplication,		FVector2f(TextureId, 0), Color);
-	const int32 idx2 = AddVertex(MeshData, Vertex3, Normal, Tangent, FVector2f(1,0)*UVMultiplication,	FVector2f(TextureId, 0), Color);
-	const int32 idx3 = AddVertex(MeshData, Vertex4, Normal, Tangent, FVector2f(1)*UVMultiplication,		FVector2f(TextureId, 0), Color);
-					
-	MeshData.Triangles.AddTriangle(idx0, idx2, idx1);
-	MeshData.Triangles.AddTriangle(idx0, idx3, idx2);
+	const int32 FirstVertex = InQuadIndex * 4;
+	int32 Indices[4];
+	for (int32 Vertex = 0; Vertex < 4; ++Vertex)
+	{
+		const float* Position = &InSideMesh.Positions[(FirstVertex + Vertex) * 3];
+		const uint8 AmbientOcclusion = InSideMesh.VertexOcclusion[FirstVertex + Vertex];
+		FColor VertexColor = Color;
+		if(AmbientOcclusion != 3)
+		{
+			FLinearColor LinearColor = FLinearColor(Color) * (1.0f - AmbientOcclusionStrength * (3 - AmbientOcclusion) / 3.0f);
+			LinearColor.A = Color.A / 255.0f;
+			VertexColor = LinearColor.ToFColor(true);
+		}
+		Indices[Vertex] = AddVertex(MeshData, FVector(Position[0], Position[1], Position[2]) * InBlockSize - InOffset, Normal, Tangent,
+			QuadUVs[Vertex] * UVMultiplication, FVector2f(TextureId, 0), VertexColor);
+	}
+
+	// The mesher already picked the diagonal, its indices count from the first vertex of the side
+	const uint32* Triangles = &InSideMesh.Indices[InQuadIndex * 6];
+	MeshData.Triangles.AddTriangle(Indices[Triangles[0] - FirstVertex], Indices[Triangles[1] - FirstVertex], Indices[Triangles[2] - FirstVertex]);
+	MeshData.Triangles.AddTriangle(Indices[Triangles[3] - FirstVertex], Indices[Triangles[4] - FirstVertex], Indices[Triangles[5] - FirstVertex]);
 }
 
+FColor URuntimeMeshProviderChunk::ShadeColor(const FColor& InColor, const uint8 InLight, const FWorldConfig& InWorldConfig)
+{
+	if(!InWorldConfig.bBakeLighting) return InColor;
+
+	const uint8 Level = FMath::Max(InLight >> 4, InLight & 0x0F);
+	const float Brightness = FMath::Lerp(InWorldConfig.AmbientLight, 1.0f, FMath::Pow(0.8f, 15 - Level));
+	FLinearColor Color = FLinearColor(InColor) * Brightness;
+	Color.A = InColor.A / 255.0f;
+	return Color.ToFColor(true);
+}
 
 FRuntimeMeshCollisionSettings URuntimeMeshProviderChunk::GetCollisionSettings()
 {
 	FRuntimeMeshCollisionSettings Settings;
 	Settings.bUseAsyncCooking = true;
-	Settings.bUseComplexAsSimple = true;
+	Settings.bUseComplexAsSimple = !bUseSimpleCollision;
+
+	if(bUseSimpleCollision && bCollisionEnabled && Chunk != nullptr)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GenerateCollisionMesh);
+		FScopeLock Lock(&PropertySyncRoot);
+		const FWorldConfig& WorldConfig = Chunk->GetChunkConfig().WorldConfig;
+		TArray<FChunkCollisionBuilder::FCollisionBox> Boxes;
+		FChunkCollisionBuilder::BuildBoxes(Chunk->GetBlocks(), WorldConfig, Boxes);
+
+		const FVector Offset = FVector(GetBounds().BoxExtent.X, GetBounds().BoxExtent.Y, 0.0f);
+		for (const auto& Box : Boxes)
+		{
+			const FVector BoxStart = FVector(Box.Min)*WorldConfig.BlockSize - Offset;
+			const FVector BoxSize = FVector(Box.Max - Box.Min + FIntVector(1))*WorldConfig.BlockSize;
+			Settings.Boxes.Emplace(BoxStart + BoxSize/2, FRotator::ZeroRotator, BoxSize);
+		}
+	}
 	return Settings;
 }
 
@@ -127,374 +194,137 @@ bool URuntimeMeshProviderChunk::IsThreadSafe()
 	return true;
 }
 
-void URuntimeMeshProviderChunk::GreedyMesh(FRuntimeMeshRenderableMeshData& MeshData)
+void URuntimeMeshProviderChunk::GreedyMesh(const TArray<FRuntimeMeshRenderableMeshData*>& SideMeshData)
 {
 	FScopeLock Lock(&PropertySyncRoot);
 	SCOPED_NAMED_EVENT(URuntimeMeshProviderChunk_GenerateGreedyMesh, FColor::Cyan);
 
-	
 	const FWorldConfig& WorldConfig = Chunk->GetChunkConfig().WorldConfig;
+	const FIntVector& ChunkSize = WorldConfig.ChunkSize;
+	const TChunkData& ChunkBlocks = Chunk->GetBlocks();
 
-	struct FState
-	{
-		FIntVector start;
-		FIntVector end;
-		bool active = false;
-		bool generateSide = false;
-		FBlock block;
-		TMap<FIntVector, bool> visited;
-		FState()
-		{
-		}
-	};
-
-	struct FBlockData
+	// Plain copies in chunk data order, X first
+	std::vector<VoxelCore::FRunBlock> Blocks;
+	Blocks.reserve(ChunkSize.X * ChunkSize.Y * ChunkSize.Z);
+	for (const FBlock& block : ChunkBlocks)
 	{
-		FBlock Block;
-		FIntVector Position;
-		FSides Sides;
-
-		FBlockData(): Block(Air), Position{0}, Sides{false}{}
-		FBlockData(FBlock InBlock, const FIntVector& InPosition, const FSides& InSides) :
-			Block(InBlock),
-			Position(InPosition),
-		    Sides(InSides)
-		{
-		}
-	};
-
-	auto GetGreedyTile = [&](FState& State, const FBlockData BlockData, const FSides::ESide Side)
+		Blocks.push_back({block.BlockTypeID, block.bIsVisible});
+	}
+	std::vector<uint8_t> Light;
+	if(WorldConfig.bBakeLighting)
 	{
-		int32  ChunkEndA = 0, ChunkEndB = 0;
-		switch (Side)
+		Light.reserve(Blocks.size());
+		for (int32 Z = 0; Z < ChunkSize.Z; ++Z)
 		{
-			case FSides::Top:
-			case FSides::Bottom:
-				ChunkEndA = WorldConfig.ChunkSize.X - BlockData.Position.X;
-				ChunkEndB = WorldConfig.ChunkSize.Y - BlockData.Position.Y;
-				break;
-			case FSides::Front:
-			case FSides::Back:
-				ChunkEndA = WorldConfig.ChunkSize.X - BlockData.Position.X;
-				ChunkEndB = WorldConfig.ChunkSize.Z - BlockData.Position.Z;
-				break;
-				
-			case FSides::Right:
-			case FSides::Left:
-				ChunkEndA = WorldConfig.ChunkSize.Y - BlockData.Position.Y;
-				ChunkEndB = WorldConfig.ChunkSize.Z - BlockData.Position.Z;
-			break;
-		}
-		
-		if(BlockData.Block != Air && BlockData.Sides.HasSide(Side) && !State.visited.Find(BlockData.Position))
-		{
-			State.active = true;
-			State.block = BlockData.Block;
-			State.start = BlockData.Position;
-			State.end = BlockData.Position;
-			FIntVector tempEnd = BlockData.Position;
-			int BreakIndex = MAX_int32;
-			for (int B = 0; B < ChunkEndB && State.active; ++B)
+			for (int32 Y = 0; Y < ChunkSize.Y; ++Y)
 			{
-				for (int A = 0; A < ChunkEndA && State.active; ++A)
+				for (int32 X = 0; X < ChunkSize.X; ++X)
 				{
-					if(A == 0 && B == 0)
-					{
-						continue;
-					} 
-					if(B >= 1 && BreakIndex == MAX_int32)
-					{
-						BreakIndex = ChunkEndA;
-						State.end = tempEnd;
-					}
-					FIntVector BlockPosition;
-					switch (Side)
-					{
-						case FSides::Top:
-						case FSides::Bottom:
-							BlockPosition = {BlockData.Position.X+A, BlockData.Position.Y+B, BlockData.Position.Z};
-							break;
-						case FSides::Front:
-						case FSides::Back:
-							BlockPosition = {BlockData.Position.X+A, BlockData.Position.Y, BlockData.Position.Z+B};
-							break;
-				
-						case FSides::Right:
-						case FSides::Left:
-							BlockPosition = {BlockData.Position.X, BlockData.Position.Y+A, BlockData.Position.Z+B};
-							break;
-					}
-					const FBlock Block = Chunk->GetBlock(BlockPosition);
-					const FSides Sides = GetSidesToRender(BlockPosition);
-					if(Block != Air && Block == State.block && Sides.HasSide(Side) && !State.visited.Find(BlockPosition))
-					{
-						tempEnd = BlockPosition;
-						if(B >= ChunkEndB-1 && (A >= ChunkEndA-1 || A >= BreakIndex-1))
-						{
-							State.end = tempEnd;
-						}
-					} else
-					{
-						if(BreakIndex == MAX_int32)
-						{
-							BreakIndex = A;
-							State.end = tempEnd;
-						} else
-						{
-							State.active = false;
-							break;
-						}
-					}
-					if(A >= BreakIndex-1)
-					{
-						State.end = tempEnd;
-						break;
-					}
+					Light.push_back(ChunkBlocks.GetLight(FIntVector(X, Y, Z)));
 				}
 			}
-			State.generateSide = true;
 		}
-	};
-	
-	FState Top, Bottom, Front, Back, Right, Left;
-	Top.generateSide = false;
-	Bottom.generateSide = false;
-	Front.generateSide = false;
-	Back.generateSide = false;
-	Right.generateSide = false;
-	Left.generateSide = false;
-	for (int Z = 0; Z < WorldConfig.ChunkSize.Z; ++Z)
-	{
-		for (int Y = 0; Y < WorldConfig.ChunkSize.Y; ++Y)
-		{
-			for (int X = 0; X < WorldConfig.ChunkSize.X; ++X)
-			{
-				FIntVector BlockPosition(X,Y,Z);
-				FBlockData BlockData(Chunk->GetBlock(BlockPosition), BlockPosition, GetSidesToRender(BlockPosition));
-				if(BlockData.Block.BlockTypeID >= WorldConfig.BlockTypes.Num()) continue;
-				// Top
-				GetGreedyTile(Top, BlockData, FSides::Top);
-				if(Top.generateSide)
-				{
-					int YsMax = Top.end.Y - Top.start.Y;
-					int XsMax = Top.end.X - Top.start.X;
-					for (int Ys = 0; Ys <= YsMax; ++Ys)
-					{
-						for (int Xs = 0; Xs <= XsMax; ++Xs)
-						{
-							Top.visited.Add(FIntVector(X+Xs, Y+Ys, Z), true);
-						}
-					}
-					FBlockType tileType = WorldConfig.BlockTypes[Top.block.BlockTypeID];
-					FVector PositionStart = FVector(Top.start)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FVector PositionEnd = FVector(Top.end)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FVector QuadSize(FVector(Top.end-Top.start) + FVector(1));
-					FVector2f UVMultiplication = FVector2f(QuadSize.X, QuadSize.Y).GetAbs();
-					AddQuad(MeshData,
-						BlockVertices[7] + FVector(PositionStart.X, PositionEnd.Y, PositionStart.Z),
-						BlockVertices[4] + PositionStart,
-						BlockVertices[5] + FVector(PositionEnd.X, PositionStart.Y, PositionStart.Z),
-						BlockVertices[6] + PositionEnd,
-						{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f},
-						tileType.TextureId, UVMultiplication,
-						tileType.Color);
-					Top.active = false;
-					Top.generateSide = false;
-				}
-
-				// Bottom
-				GetGreedyTile(Bottom, BlockData, FSides::Bottom);
-				if(Bottom.generateSide)
-				{
-					int YsMax = Bottom.end.Y - Bottom.start.Y;
-					int XsMax = Bottom.end.X - Bottom.start.X;
-					for (int Ys = 0; Ys <= YsMax; ++Ys)
-					{
-						for (int Xs = 0; Xs <= XsMax; ++Xs)
-						{
-							Bottom.visited.Add(FIntVector(X+Xs, Y+Ys, Z), true);
-						}
-					}
-					FBlockType tileType = WorldConfig.BlockTypes[Bottom.block.BlockTypeID];
-					FVector PositionStart = FVector(Bottom.start)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FVector PositionEnd = FVector(Bottom.end)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FColor Color = tileType.bSideDiffers ? tileType.SideColor : tileType.Color;
-					FVector QuadSize(FVector(Bottom.end-Bottom.start) + FVector(1));
-					FVector2f UVMultiplication = FVector2f(QuadSize.X, QuadSize.Y).GetAbs();
-					AddQuad(MeshData,
-						BlockVertices[0] + PositionStart,
-						BlockVertices[3] + FVector(PositionStart.X, PositionEnd.Y, PositionStart.Z),
-						BlockVertices[2] + PositionEnd,
-						BlockVertices[1] + FVector(PositionEnd.X, PositionStart.Y, PositionStart.Z),
-						{0.0f, 0.0f, -1.0f}, {-1.0f, 0.0f, 0.0f},
-						tileType.TextureId, UVMultiplication,
-						Color);
-					Bottom.active = false;
-					Bottom.generateSide = false;
-				}
-
-				// Front
-				GetGreedyTile(Front, BlockData, FSides::Front);
-				if(Front.generateSide)
-				{
-					int ZsMax = Front.end.Z - Front.start.Z;
-					int XsMax = Front.end.X - Front.start.X;
-					for (int Zs = 0; Zs <= ZsMax; ++Zs)
-					{
-						for (int Xs = 0; Xs <= XsMax; ++Xs)
-						{
-							Front.visited.Add(FIntVector(X+Xs, Y, Z+Zs), true);
-						}
-					}
-					FBlockType tileType = WorldConfig.BlockTypes[Front.block.BlockTypeID];
-					FVector PositionStart = FVector(Front.start)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FVector PositionEnd = FVector(Front.end)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FColor Color = tileType.bSideDiffers ? tileType.SideColor : tileType.Color;
-					FVector QuadSize(FVector(Front.end-Front.start) + FVector(1));
-					FVector2f UVMultiplication = FVector2f(QuadSize.X, QuadSize.Y).GetAbs();
-					AddQuad(MeshData,
-						BlockVertices[3] + PositionStart,
-						BlockVertices[7] + FVector(PositionStart.X, PositionStart.Y, PositionEnd.Z),
-						BlockVertices[6] + PositionEnd,
-						BlockVertices[2] + FVector(PositionEnd.X, PositionStart.Y, PositionStart.Z),
-						{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f},
-						tileType.TextureId, UVMultiplication,
-						Color);
-					Front.active = false;
-					Front.generateSide = false;
-				}
+	}
 
-				// Back
-				GetGreedyTile(Back, BlockData, FSides::Back);
-				if(Back.generateSide)
-				{
-					int ZsMax = Back.end.Z - Back.start.Z;
-					int XsMax = Back.end.X - Back.start.X;
-					for (int Zs = 0; Zs <= ZsMax; ++Zs)
-					{
-						for (int Xs = 0; Xs <= XsMax; ++Xs)
-						{
-							Back.visited.Add(FIntVector(X+Xs, Y, Z+Zs), true);
-						}
-					}
-					FBlockType tileType = WorldConfig.BlockTypes[Back.block.BlockTypeID];
-					FVector PositionStart = FVector(Back.end)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FVector PositionEnd = FVector(Back.start)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FColor Color = tileType.bSideDiffers ? tileType.SideColor : tileType.Color;
-					FVector QuadSize(FVector(Back.end-Back.start) + FVector(1));
-					FVector2f UVMultiplication = FVector2f(QuadSize.X, QuadSize.Y).GetAbs();
-					AddQuad(MeshData,
-						BlockVertices[1] + FVector(PositionStart.X, PositionStart.Y, PositionEnd.Z),
-						BlockVertices[5] + PositionStart,
-						BlockVertices[4] + FVector(PositionEnd.X, PositionStart.Y, PositionStart.Z),
-						BlockVertices[0] + PositionEnd,
-						{0.0f, -1.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
-						tileType.TextureId, UVMultiplication,
-						Color);
-					Back.active = false;
-					Back.generateSide = false;
-				}
+	VoxelCore::FMesherInput Input;
+	Input.Size[0] = ChunkSize.X;
+	Input.Size[1] = ChunkSize.Y;
+	Input.Size[2] = ChunkSize.Z;
+	Input.Blocks = Blocks.data();
+	Input.Light = WorldConfig.bBakeLighting ? Light.data() : nullptr;
+	// Only the border comes from the neighbors, through the same lookups as the rest of the chunk code
+	Input.GetBorder = [this](const int32_t X, const int32_t Y, const int32_t Z, VoxelCore::FRunBlock& OutBlock, uint8_t& OutLight)
+	{
+		const FIntVector Position(X, Y, Z);
+		const FBlock block = Chunk->GetBlock(Position);
+		OutBlock = {block.BlockTypeID, block.bIsVisible};
+		OutLight = Chunk->GetLight(Position);
+	};
+	Input.BlockTypeCount = WorldConfig.BlockTypes.Num();
+	Input.bAmbientOcclusion = WorldConfig.bBakeAmbientOcclusion;
 
-				// Right
-				GetGreedyTile(Right, BlockData, FSides::Right);
-				if(Right.generateSide)
-				{
-					int ZsMax = Right.end.Z - Right.start.Z;
-					int YsMax = Right.end.Y - Right.start.Y;
-					for (int Zs = 0; Zs <= ZsMax; ++Zs)
-					{
-						for (int Ys = 0; Ys <= YsMax; ++Ys)
-						{
-							Right.visited.Add(FIntVector(X, Y+Ys, Z+Zs), true);
-						}
-					}
-					FBlockType tileType = WorldConfig.BlockTypes[Right.block.BlockTypeID];
-					FVector PositionStart = FVector(Right.start)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FVector PositionEnd = FVector(Right.end)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FColor Color = tileType.bSideDiffers ? tileType.SideColor : tileType.Color;
-					FVector QuadSize(FVector(Right.end-Right.start) + FVector(1));
-					FVector2f UVMultiplication = FVector2f(QuadSize.X, QuadSize.Y).GetAbs();
-					AddQuad(MeshData,
-						BlockVertices[2] + FVector(PositionStart.X, PositionEnd.Y, PositionStart.Z),
-						BlockVertices[6] + PositionEnd,
-						BlockVertices[5] + FVector(PositionStart.X, PositionStart.Y, PositionEnd.Z),
-						BlockVertices[1] + PositionStart,
-						{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
-						tileType.TextureId, UVMultiplication,
-						Color);
-					Right.active = false;
-					Right.generateSide = false;
-				}
+	VoxelCore::FSideMesh SideMeshes[VoxelCore::MeshSideCount];
+	VoxelCore::GreedyMesh(Input, SideMeshes);
 
-				// Left
-				GetGreedyTile(Left, BlockData, FSides::Left);
-				if(Left.generateSide)
-				{
-					int ZsMax = Left.end.Z - Left.start.Z;
-					int YsMax = Left.end.Y - Left.start.Y;
-					for (int Zs = 0; Zs <= ZsMax; ++Zs)
-					{
-						for (int Ys = 0; Ys <= YsMax; ++Ys)
-						{
-							Left.visited.Add(FIntVector(X, Y+Ys, Z+Zs), true);
-						}
-					}
-					FBlockType tileType = WorldConfig.BlockTypes[Left.block.BlockTypeID];
-					FVector PositionStart = FVector(Left.start)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FVector PositionEnd = FVector(Left.end)*WorldConfig.BlockSize - FVector(GetBounds().BoxExtent.X,GetBounds().BoxExtent.Y,0.0f);
-					FColor Color = tileType.bSideDiffers ? tileType.SideColor : tileType.Color;
-					FVector QuadSize(FVector(Left.end-Left.start) + FVector(1));
-					FVector2f UVMultiplication = FVector2f(QuadSize.X, QuadSize.Y).GetAbs();
-					AddQuad(MeshData,
-						BlockVertices[0] + PositionStart,
-						BlockVertices[4] + FVector(PositionStart.X, PositionStart.Y, PositionEnd.Z),
-						BlockVertices[7] + PositionEnd,
-						BlockVertices[3] + FVector(PositionEnd.X, PositionEnd.Y, PositionStart.Z),
-						{-1.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
-						tileType.TextureId, UVMultiplication,
-						Color);
-					Left.active = false;
-					Left.generateSide = false;
-				}
-			}
-		}	
+	const FVector Offset(GetBounds().BoxExtent.X, GetBounds().BoxExtent.Y, 0.0f);
+	for (int32 SideIndex = 0; SideIndex < FSides::Num; ++SideIndex)
+	{
+		const FSides::ESide Side = FSides::GetSide(SideIndex);
+		const FVector Normal(FSides::GetSideOffset(Side));
+		const VoxelCore::FSideMesh& SideMesh = SideMeshes[SideIndex];
+		for (int32 QuadIndex = 0; QuadIndex < static_cast<int32>(SideMesh.Quads.size()); ++QuadIndex)
+		{
+			const VoxelCore::FMeshQuad& Quad = SideMesh.Quads[QuadIndex];
+			const FBlockType& tileType = WorldConfig.BlockTypes[Quad.Block.BlockTypeId];
+			const FColor Color = Side != FSides::Top && tileType.bSideDiffers ? tileType.SideColor : tileType.Color;
+			const FVector2f UVMultiplication(Quad.Max[0] - Quad.Min[0] + 1, Quad.Max[1] - Quad.Min[1] + 1);
+			AddQuad(*SideMeshData[SideIndex], SideMesh, QuadIndex, WorldConfig.BlockSize, Offset, Normal, SideTangents[SideIndex],
+				tileType.TextureId, UVMultiplication, ShadeColor(Color, Quad.Light, WorldConfig), WorldConfig.AmbientOcclusionStrength);
+		}
 	}
 }
 
-FSides URuntimeMeshProviderChunk::GetSidesToRender(const FIntVector InPosition) const
+int32 URuntimeMeshProviderChunk::GetSectionCount() const
+{
+	return bSplitSectionsByDirection ? FSides::Num : 1;
+}
+
+void URuntimeMeshProviderChunk::MarkMeshDirty()
 {
-	FSides SidesToRender(true);
-	if(const auto block = Chunk->GetBlock({InPosition.X, InPosition.Y, InPosition.Z+1});
-		block != Air) // Top
-	{
-		SidesToRender.SetSide(FSides::Top, false);
-	}
-	if(const auto block = Chunk->GetBlock({InPosition.X, InPosition.Y, InPosition.Z-1});
-		block != Air) // Bottom
-	{
-		SidesToRender.SetSide(FSides::Bottom, false);
-	}
-	if(const auto block = Chunk->GetBlock({InPosition.X, InPosition.Y+1, InPosition.Z});
-		block != Air) // Front
-	{
-		SidesToRender.SetSide(FSides::Front, false);
-	}
-	if(const auto block = Chunk->GetBlock({InPosition.X-1, InPosition.Y, InPosition.Z});
-		block != Air) // Left
 	{
-		SidesToRender.SetSide(FSides::Left, false);
+		FScopeLock Lock(&PropertySyncRoot);
+		MeshRevision++;
 	}
-	if(const auto block = Chunk->GetBlock({InPosition.X, InPosition.Y-1, InPosition.Z});
-		block != Air) // Back
+	if(bUseSimpleCollision && bCollisionEnabled)
 	{
-		SidesToRender.SetSide(FSides::Back, false);
+		MarkCollisionDirty();
 	}
-	if(const auto block = Chunk->GetBlock({InPosition.X+1, InPosition.Y, InPosition.Z});
-		block != Air) // Right
+}
+
+void URuntimeMeshProviderChunk::GetMeshData(FRuntimeMeshRenderableMeshData& OutMeshData)
+{
+	FScopeLock Lock(&PropertySyncRoot);
+	if(Chunk == nullptr) return;
+	OutMeshData.TexCoords = FRuntimeMeshVertexTexCoordStream(2);
+	TArray<FRuntimeMeshRenderableMeshData*> SideMeshData;
+	SideMeshData.Init(&OutMeshData, FSides::Num);
+	GreedyMesh(SideMeshData);
+}
+
+void URuntimeMeshProviderChunk::SetCollisionEnabled(const bool bInCollisionEnabled)
+{
+	if(!bUseSimpleCollision || bCollisionEnabled == bInCollisionEnabled) return;
+	bCollisionEnabled = bInCollisionEnabled;
+	MarkCollisionDirty();
+}
+
+void URuntimeMeshProviderChunk::UpdateSideVisibility(const FVector& InViewLocation)
+{
+	if(!bSplitSectionsByDirection || Chunk == nullptr) return;
+
+	const FWorldConfig& WorldConfig = Chunk->GetChunkConfig().WorldConfig;
+	const FBox Bounds = GetBounds().GetBox().ExpandBy(WorldConfig.DirectionCullingMargin);
+	FSides Sides(false);
+	Sides.SetSide(FSides::Top,		InViewLocation.Z > Bounds.Min.Z);
+	Sides.SetSide(FSides::Bottom,	InViewLocation.Z < Bounds.Max.Z);
+	Sides.SetSide(FSides::Front,	InViewLocation.Y > Bounds.Min.Y);
+	Sides.SetSide(FSides::Back,		InViewLocation.Y < Bounds.Max.Y);
+	Sides.SetSide(FSides::Right,	InViewLocation.X > Bounds.Min.X);
+	Sides.SetSide(FSides::Left,		InViewLocation.X < Bounds.Max.X);
+	if(Sides.Sides == VisibleSides.Sides) return;
+
+	for (int32 SideIndex = 0; SideIndex < FSides::Num; ++SideIndex)
 	{
-		SidesToRender.SetSide(FSides::Right, false);
+		const FSides::ESide Side = FSides::GetSide(SideIndex);
+		if(Sides.HasSide(Side) != VisibleSides.HasSide(Side))
+		{
+			for (int32 LODIndex = 0; LODIndex < WorldConfig.LODs.Num(); ++LODIndex)
+			{
+				SetSectionVisibility(LODIndex, SideIndex, Sides.HasSide(Side));
+			}
+		}
 	}
-	return SidesToRender;
+	VisibleSides = Sides;
 }
 
 const UChunk* URuntimeMeshProviderChunk::GetChunk() const
@@ -505,4 +335,6 @@ const UChunk* URuntimeMeshProviderChunk::GetChunk() const
 void URuntimeMeshProviderChunk::SetChunk(const UChunk* InChunk)
 {
 	Chunk = InChunk;
+	bSplitSectionsByDirection = Chunk != nullptr && Chunk->GetChunkConfig().WorldConfig.bSplitSectionsByDirection;
+	bUseSimpleCollision = Chunk != nullptr && Chunk->GetChunkConfig().WorldConfig.bUseSimpleCollision;
 }
\ No newline at end of file
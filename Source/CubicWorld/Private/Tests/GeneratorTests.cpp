@@ -0,0 +1,504 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+// Generator checks and throughput, for example
+// UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests CubicWorld.Generator; Quit"
+
+#include "World/BiomeGenerator.h"
+#include "World/CaveCarverStage.h"
+#include "World/DensityGenerator.h"
+#include "World/FastNoiseLite.h"
+#include "World/GeneratorRunner.h"
+#include "World/SimpleGenerator.h"
+#include "World/TreeStage.h"
+#include "VoxelCore/ChunkCodec.h"
+#include "Algo/Reverse.h"
+#include "Async/ParallelFor.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	const TCHAR* const GeneratorNames[] = {TEXT("Simple"), TEXT("Density"), TEXT("Biome")};
+
+	struct FGoldenHash
+	{
+		const TCHAR* Generator;
+		int32 Seed;
+		uint32 Hash;
+	};
+	// Hashes of the golden chunks with the default FWorldConfig, 0 is not recorded yet and only warns with the hash to put here.
+	// Record them again when a generator changes its output on purpose, the grid noise can also round differently per compiler.
+	// CubicWorld.Generator.SimpleMatchesGetTile does not need recorded values, it checks the chunk path against GetTile
+	const FGoldenHash GoldenHashes[] = {
+		{TEXT("Simple"), 1337, 0},
+		{TEXT("Simple"), 4242, 0},
+		{TEXT("Density"), 1337, 0},
+		{TEXT("Density"), 4242, 0},
+		{TEXT("Biome"), 1337, 0},
+		{TEXT("Biome"), 4242, 0},
+	};
+
+	// Stone, dirt with grass on top and snow, the same for every generator
+	TArray<FBlockLayer> MakeLayers(const float InScale)
+	{
+		TArray<FBlockLayer> layers;
+		layers.AddDefaulted(3);
+		layers[0].Height = 0.4f * InScale;
+		layers[0].BlockTypeId = 1;
+		layers[1].Height = 0.6f * InScale;
+		layers[1].BlockTypeId = 2;
+		layers[1].bTopBlockDiffers = true;
+		layers[1].TopBlockTypeId = 3;
+		layers[2].Height = 1.0f;
+		layers[2].BlockTypeId = 4;
+		return layers;
+	}
+
+	UGenerator* MakeGenerator(const FString& InName, const int32 InSeed)
+	{
+		if(InName == TEXT("Simple"))
+		{
+			USimpleGenerator* generator = NewObject<USimpleGenerator>();
+			generator->NoiseConfig.Seed = InSeed;
+			generator->DistortionNoiseConfig.Seed = InSeed + 1;
+			generator->Layers = MakeLayers(1.0f);
+			return generator;
+		}
+		if(InName == TEXT("Density"))
+		{
+			UDensityGenerator* generator = NewObject<UDensityGenerator>();
+			generator->HeightNoiseConfig.Seed = InSeed;
+			generator->DensityNoiseConfig.Seed = InSeed + 1;
+			generator->Layers = MakeLayers(1.0f);
+			return generator;
+		}
+		if(InName == TEXT("Biome"))
+		{
+			UBiomeGenerator* generator = NewObject<UBiomeGenerator>();
+			generator->TemperatureNoiseConfig.Seed = InSeed;
+			generator->HumidityNoiseConfig.Seed = InSeed + 1;
+			generator->Biomes.AddDefaulted(2);
+			generator->Biomes[0].Name = TEXT("Plains");
+			generator->Biomes[0].NoiseConfig.Seed = InSeed + 2;
+			generator->Biomes[0].Layers = MakeLayers(1.0f);
+			generator->Biomes[1].Name = TEXT("Hills");
+			generator->Biomes[1].Temperature = -0.5f;
+			generator->Biomes[1].Humidity = 0.5f;
+			generator->Biomes[1].NoiseConfig.Seed = InSeed + 3;
+			generator->Biomes[1].MaxHeight = 0.9f;
+			generator->Biomes[1].Layers = MakeLayers(0.8f);
+			return generator;
+		}
+		return nullptr;
+	}
+
+	// Every chunk of a square of columns around the origin
+	TArray<FIntVector> MakePositions(const FWorldConfig& InWorldConfig, const int32 InChunksPerSide)
+	{
+		TArray<FIntVector> positions;
+		for (int32 Z = 0; Z < InWorldConfig.MaxChunksZ; ++Z)
+		{
+			for (int32 Y = -InChunksPerSide / 2; Y < InChunksPerSide - InChunksPerSide / 2; ++Y)
+			{
+				for (int32 X = -InChunksPerSide / 2; X < InChunksPerSide - InChunksPerSide / 2; ++X)
+				{
+					positions.Emplace(X, Y, Z);
+				}
+			}
+		}
+		return positions;
+	}
+
+	uint32 HashChunk(const FIntVector& InPosition, TChunkData& InChunk, const uint32 InHash)
+	{
+		uint32 hash = FCrc::MemCrc32(&InPosition, sizeof(FIntVector), InHash);
+		for (const FBlock& block : InChunk.GetBlocks())
+		{
+			const uint8 value[2] = {block.BlockTypeID, block.bIsVisible};
+			hash = FCrc::MemCrc32(value, sizeof(value), hash);
+		}
+		return hash;
+	}
+
+	uint32 HashChunks(const TArray<FIntVector>& InPositions, TArray<TChunkData>& InChunks)
+	{
+		uint32 hash = 0;
+		for (int32 Index = 0; Index < InPositions.Num(); ++Index)
+		{
+			hash = HashChunk(InPositions[Index], InChunks[Index], hash);
+		}
+		return hash;
+	}
+
+	// Seconds to generate all chunks, OutChunks is filled in the order of InPositions
+	double GenerateChunks(UGenerator* InGenerator, const FWorldConfig& InWorldConfig, const TArray<FIntVector>& InPositions, const bool bInParallel, TArray<TChunkData>& OutChunks)
+	{
+		OutChunks.Reset();
+		for (int32 Index = 0; Index < InPositions.Num(); ++Index)
+		{
+			OutChunks.Emplace(InWorldConfig.ChunkSize);
+		}
+		const double Start = FPlatformTime::Seconds();
+		ParallelFor(InPositions.Num(), [&](const int32 Index)
+		{
+			InGenerator->GenerateChunk(FChunkConfig(InWorldConfig, InPositions[Index]), OutChunks[Index]);
+		}, bInParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+		return FPlatformTime::Seconds() - Start;
+	}
+
+	// Runs of one block type up a column, as the type and the first Z of the run
+	TArray<TPair<uint8, int32>> GetColumnRuns(const TArray<uint8>& InColumn)
+	{
+		TArray<TPair<uint8, int32>> runs;
+		for (int32 Z = 0; Z < InColumn.Num(); ++Z)
+		{
+			if(runs.IsEmpty() || runs.Last().Key != InColumn[Z])
+			{
+				runs.Add({InColumn[Z], Z});
+			}
+		}
+		return runs;
+	}
+
+	// Same block types in the same order, every border moved by at most InTolerance blocks
+	bool DoColumnsMatch(const TArray<uint8>& InColumn, const TArray<uint8>& InExpected, const int32 InTolerance)
+	{
+		const TArray<TPair<uint8, int32>> runs = GetColumnRuns(InColumn);
+		const TArray<TPair<uint8, int32>> expected = GetColumnRuns(InExpected);
+		if(runs.Num() != expected.Num()) return false;
+		for (int32 Index = 0; Index < runs.Num(); ++Index)
+		{
+			if(runs[Index].Key != expected[Index].Key || FMath::Abs(runs[Index].Value - expected[Index].Value) > InTolerance) return false;
+		}
+		return true;
+	}
+
+	// Round trips the chunks through the chunk file codec, false if a chunk comes back different
+	bool RoundTripCodec(FAutomationTestBase& Test, const FString& InName, TArray<TChunkData>& InChunks)
+	{
+		std::vector<std::vector<uint8_t>> Encoded;
+		size_t Bytes = 0;
+		double Start = FPlatformTime::Seconds();
+		for (const TChunkData& chunk : InChunks)
+		{
+			const FIntVector& ChunkSize = chunk.GetChunkSize();
+			VoxelCore::FChunkEncoder encoder(ChunkSize.X, ChunkSize.Y, ChunkSize.Z);
+			for (const FBlock& block : chunk)
+			{
+				encoder.Add({block.BlockTypeID, block.bIsVisible});
+			}
+			Bytes += Encoded.emplace_back(encoder.Finish()).size();
+		}
+		const double Encode = FPlatformTime::Seconds() - Start;
+
+		std::vector<std::vector<VoxelCore::FBlockRun>> Decoded;
+		bool bRoundTrips = true;
+		Start = FPlatformTime::Seconds();
+		for (const std::vector<uint8_t>& data : Encoded)
+		{
+			int32_t ChunkSize[3];
+			bRoundTrips &= VoxelCore::DecodeChunk(data.data(), data.size(), ChunkSize, Decoded.emplace_back());
+		}
+		const double Decode = FPlatformTime::Seconds() - Start;
+
+		for (int32 Index = 0; Index < InChunks.Num() && bRoundTrips; ++Index)
+		{
+			const TArray<FBlock>& blocks = InChunks[Index].GetBlocks();
+			int32 BlockIndex = 0;
+			for (const VoxelCore::FBlockRun& run : Decoded[Index])
+			{
+				for (uint32 Count = 0; Count < run.Count && bRoundTrips; ++Count, ++BlockIndex)
+				{
+					bRoundTrips &= blocks.IsValidIndex(BlockIndex) && blocks[BlockIndex].BlockTypeID == run.Block.BlockTypeId && blocks[BlockIndex].bIsVisible == run.Block.bIsVisible;
+				}
+			}
+			bRoundTrips &= BlockIndex == blocks.Num();
+		}
+
+		Test.AddInfo(FString::Printf(TEXT("%s: %.1f bytes per chunk encoded, %.1f chunks/s encode, %.1f chunks/s decode"),
+			*InName, static_cast<double>(Bytes) / InChunks.Num(), InChunks.Num() / Encode, InChunks.Num() / Decode));
+		return bRoundTrips;
+	}
+
+	// Generates InPositions in that order through the staged pipeline, OutChunks also gets the late structure writes
+	bool RunPipeline(FAutomationTestBase& Test, UGenerator* InGenerator, const FWorldConfig& InWorldConfig, const TArray<FIntVector>& InPositions, TMap<FIntVector, TChunkData>& OutChunks)
+	{
+		FGeneratorRunner* runner = new FGeneratorRunner(InGenerator, InWorldConfig);
+		for (const FIntVector& position : InPositions)
+		{
+			runner->AddTask(position, TChunkData(InWorldConfig.ChunkSize));
+		}
+
+		bool bIsComplete = true;
+		const double Timeout = FPlatformTime::Seconds() + 60.0;
+		TPair<FIntVector, TChunkData> result;
+		while (OutChunks.Num() < InPositions.Num())
+		{
+			if(runner->Results.Dequeue(result))
+			{
+				if(OutChunks.Contains(result.Key))
+				{
+					Test.AddError(FString::Printf(TEXT("Chunk %s was handed out twice"), *result.Key.ToString()));
+				}
+				OutChunks.Add(result.Key, MoveTemp(result.Value));
+				continue;
+			}
+			if(FPlatformTime::Seconds() > Timeout)
+			{
+				Test.AddError(FString::Printf(TEXT("Only %d of %d chunks were generated in time"), OutChunks.Num(), InPositions.Num()));
+				bIsComplete = false;
+				break;
+			}
+			FPlatformProcess::Sleep(0.001f);
+		}
+
+		runner->Stop();
+		delete runner;
+		return bIsComplete;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGeneratorGoldenHashTest, "CubicWorld.Generator.GoldenHashes", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGeneratorGoldenHashTest::RunTest(const FString& Parameters)
+{
+	const FWorldConfig WorldConfig;
+	const TArray<FIntVector> Positions = MakePositions(WorldConfig, 4);
+	for (const FGoldenHash& golden : GoldenHashes)
+	{
+		const FString Name = FString::Printf(TEXT("%s seed %d"), golden.Generator, golden.Seed);
+		const TStrongObjectPtr<UGenerator> Generator(MakeGenerator(golden.Generator, golden.Seed));
+		Generator->Init();
+
+		TArray<TChunkData> Chunks;
+		GenerateChunks(Generator.Get(), WorldConfig, Positions, false, Chunks);
+		const uint32 SingleHash = HashChunks(Positions, Chunks);
+		GenerateChunks(Generator.Get(), WorldConfig, Positions, true, Chunks);
+		const uint32 ParallelHash = HashChunks(Positions, Chunks);
+
+		if(SingleHash != ParallelHash)
+		{
+			AddError(FString::Printf(TEXT("%s: parallel generation gives %08x instead of %08x"), *Name, ParallelHash, SingleHash));
+		}
+		if(golden.Hash == 0)
+		{
+			AddWarning(FString::Printf(TEXT("%s: no golden hash recorded, got %08x"), *Name, SingleHash));
+		}
+		else if(SingleHash != golden.Hash)
+		{
+			AddError(FString::Printf(TEXT("%s: hash %08x instead of the golden %08x"), *Name, SingleHash, golden.Hash));
+		}
+		if(!RoundTripCodec(*this, Name, Chunks))
+		{
+			AddError(FString::Printf(TEXT("%s: chunks differ after encoding and decoding"), *Name));
+		}
+	}
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleGeneratorOracleTest, "CubicWorld.Generator.SimpleMatchesGetTile", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSimpleGeneratorOracleTest::RunTest(const FString& Parameters)
+{
+	const FWorldConfig WorldConfig;
+	const FIntVector& ChunkSize = WorldConfig.ChunkSize;
+	const int32 WorldHeight = WorldConfig.GetWorldBlockHeight();
+	const TArray<FIntVector> Positions = MakePositions(WorldConfig, 4);
+	for (const int32 Seed : {1337, 4242})
+	{
+		const TStrongObjectPtr<UGenerator> Generator(MakeGenerator(TEXT("Simple"), Seed));
+		Generator->Init();
+		TArray<TChunkData> Chunks;
+		GenerateChunks(Generator.Get(), WorldConfig, Positions, true, Chunks);
+
+		// Whole world columns, so chunk borders and skipped or filled chunks are checked too
+		TMap<FIntPoint, TArray<uint8>> Columns;
+		for (int32 Index = 0; Index < Positions.Num(); ++Index)
+		{
+			const FIntVector ChunkOrigin = FChunkConfig(WorldConfig, Positions[Index]).GetChunkPositionInBlocks();
+			for (int32 Y = 0; Y < ChunkSize.Y; ++Y)
+			{
+				for (int32 X = 0; X < ChunkSize.X; ++X)
+				{
+					TArray<uint8>& column = Columns.FindOrAdd(FIntPoint(ChunkOrigin.X + X, ChunkOrigin.Y + Y));
+					column.SetNum(WorldHeight);
+					for (int32 Z = 0; Z < ChunkSize.Z; ++Z)
+					{
+						column[ChunkOrigin.Z + Z] = Chunks[Index].GetBlock(FIntVector(X, Y, Z)).BlockTypeID;
+					}
+				}
+			}
+		}
+
+		// The grid noise can round differently from GetNoise, which moves a surface or layer border by one block
+		int32 Moved = 0;
+		int32 Mismatches = 0;
+		TArray<uint8> expected;
+		expected.SetNum(WorldHeight);
+		for (const TPair<FIntPoint, TArray<uint8>>& column : Columns)
+		{
+			for (int32 Z = 0; Z < WorldHeight; ++Z)
+			{
+				const TOptional<FBlock> tile = Generator->GetTile(FIntVector(column.Key.X, column.Key.Y, Z), WorldConfig);
+				expected[Z] = tile.IsSet() ? tile->BlockTypeID : Air.BlockTypeID;
+			}
+			if(column.Value == expected) continue;
+			if(DoColumnsMatch(column.Value, expected, 1))
+			{
+				Moved++;
+				continue;
+			}
+			if(Mismatches++ < 10)
+			{
+				AddError(FString::Printf(TEXT("Seed %d: column %s differs from GetTile"), Seed, *column.Key.ToString()));
+			}
+		}
+		if(Mismatches > 0)
+		{
+			AddError(FString::Printf(TEXT("Seed %d: %d of %d columns differ from GetTile"), Seed, Mismatches, Columns.Num()));
+		}
+		// Rounding only hits values right at a border, an off by one in the chunk path moves most columns
+		if(Moved > Columns.Num() / 20)
+		{
+			AddError(FString::Printf(TEXT("Seed %d: %d of %d columns have a border moved by one block"), Seed, Moved, Columns.Num()));
+		}
+		else
+		{
+			AddInfo(FString::Printf(TEXT("Seed %d: %d of %d columns have a border moved by one block"), Seed, Moved, Columns.Num()));
+		}
+	}
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGeneratorThroughputTest, "CubicWorld.Generator.Throughput", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGeneratorThroughputTest::RunTest(const FString& Parameters)
+{
+	const FWorldConfig WorldConfig;
+	const TArray<FIntVector> Positions = MakePositions(WorldConfig, 8);
+	AddInfo(FString::Printf(TEXT("Generating %d chunks of %s"), Positions.Num(), *WorldConfig.ChunkSize.ToString()));
+	for (const TCHAR* name : GeneratorNames)
+	{
+		const TStrongObjectPtr<UGenerator> Generator(MakeGenerator(name, 1337));
+		Generator->Init();
+
+		TArray<TChunkData> Chunks;
+		const double Single = GenerateChunks(Generator.Get(), WorldConfig, Positions, false, Chunks);
+		const double Parallel = GenerateChunks(Generator.Get(), WorldConfig, Positions, true, Chunks);
+		AddInfo(FString::Printf(TEXT("%s: %.1f chunks/s single threaded, %.1f chunks/s parallel"),
+			name, Positions.Num() / Single, Positions.Num() / Parallel));
+		RoundTripCodec(*this, name, Chunks);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNoiseThroughputTest, "CubicWorld.Generator.NoiseThroughput", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FNoiseThroughputTest::RunTest(const FString& Parameters)
+{
+	FastNoiseLite noise(1337);
+	noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+	noise.SetFractalType(FastNoiseLite::FractalType_FBm);
+	noise.SetFractalOctaves(3);
+
+	constexpr int32 Size = 64;
+	TArray<float> values;
+	values.SetNumUninitialized(Size * Size * Size);
+
+	double Start = FPlatformTime::Seconds();
+	for (int32 Z = 0, Index = 0; Z < Size; ++Z)
+	{
+		for (int32 Y = 0; Y < Size; ++Y)
+		{
+			for (int32 X = 0; X < Size; ++X)
+			{
+				values[Index++] = noise.GetNoise(static_cast<float>(X), static_cast<float>(Y), static_cast<float>(Z));
+			}
+		}
+	}
+	const double Scalar = FPlatformTime::Seconds() - Start;
+
+	Start = FPlatformTime::Seconds();
+	noise.GetNoiseGrid3D(values.GetData(), 0, 0, 0, Size, Size, Size);
+	const double Grid = FPlatformTime::Seconds() - Start;
+
+	// One slab per task, each with its own copy of the noise like the generators on the worker threads
+	TArray<float> parallelValues;
+	parallelValues.SetNumUninitialized(values.Num());
+	Start = FPlatformTime::Seconds();
+	ParallelFor(Size, [&](const int32 Z)
+	{
+		FastNoiseLite slabNoise = noise;
+		slabNoise.GetNoiseGrid3D(parallelValues.GetData() + Z * Size * Size, 0, 0, Z, Size, Size, 1);
+	});
+	const double ParallelGrid = FPlatformTime::Seconds() - Start;
+
+	if(FMemory::Memcmp(values.GetData(), parallelValues.GetData(), values.Num() * sizeof(float)) != 0)
+	{
+		AddError(TEXT("Grid noise generated in slabs differs from the whole grid"));
+	}
+	AddInfo(FString::Printf(TEXT("Noise 3D FBm 3 octaves: %.2f M samples/s per point, %.2f M samples/s grid, %.2f M samples/s grid on all threads"),
+		values.Num() / Scalar / 1e6, values.Num() / Grid / 1e6, values.Num() / ParallelGrid / 1e6));
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGeneratorPipelineTest, "CubicWorld.Generator.Pipeline", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGeneratorPipelineTest::RunTest(const FString& Parameters)
+{
+	const FWorldConfig WorldConfig;
+	TArray<FIntVector> Positions = MakePositions(WorldConfig, 4);
+
+	const TStrongObjectPtr<UGenerator> Generator(MakeGenerator(TEXT("Simple"), 1337));
+	UCaveCarverStage* caves = NewObject<UCaveCarverStage>(Generator.Get());
+	UTreeStage* trees = NewObject<UTreeStage>(Generator.Get());
+	// Different types, so overlapping trees only match if they resolve in the same order everywhere
+	trees->TrunkBlockTypeId = 5;
+	trees->LeavesBlockTypeId = 6;
+	Generator->Stages = {caves, trees};
+
+	// Other orders run the steps of neighboring chunks in another order
+	TMap<FIntVector, TChunkData> Chunks;
+	const double Start = FPlatformTime::Seconds();
+	if(!RunPipeline(*this, Generator.Get(), WorldConfig, Positions, Chunks)) return false;
+	AddInfo(FString::Printf(TEXT("Pipeline: %.1f chunks/s with %d stages"), Positions.Num() / (FPlatformTime::Seconds() - Start), Generator->Stages.Num()));
+	Algo::Reverse(Positions);
+	TMap<FIntVector, TChunkData> ReversedChunks;
+	if(!RunPipeline(*this, Generator.Get(), WorldConfig, Positions, ReversedChunks)) return false;
+	// Like a later session that only loads some chunks, their trees must not depend on what was generated before
+	TArray<FIntVector> SparsePositions;
+	for (int32 Index = 0; Index < Positions.Num(); Index += 3)
+	{
+		SparsePositions.Add(Positions[Index]);
+	}
+	TMap<FIntVector, TChunkData> SparseChunks;
+	if(!RunPipeline(*this, Generator.Get(), WorldConfig, SparsePositions, SparseChunks)) return false;
+
+	int32 TrunkBlocks = 0;
+	int32 LeavesBlocks = 0;
+	for (const FIntVector& position : Positions)
+	{
+		TChunkData& chunk = Chunks[position];
+		const uint32 Hash = HashChunk(position, chunk, 0);
+		if(Hash != HashChunk(position, ReversedChunks[position], 0))
+		{
+			AddError(FString::Printf(TEXT("Chunk %s differs when generated in reverse order"), *position.ToString()));
+		}
+		if(const TChunkData* sparse = SparseChunks.Find(position); sparse != nullptr && Hash != HashChunk(position, *sparse, 0))
+		{
+			AddError(FString::Printf(TEXT("Chunk %s differs when generated without its neighbors"), *position.ToString()));
+		}
+		for (const FBlock& block : chunk.GetBlocks())
+		{
+			TrunkBlocks += block.BlockTypeID == trees->TrunkBlockTypeId;
+			LeavesBlocks += block.BlockTypeID == trees->LeavesBlockTypeId;
+		}
+	}
+	TestTrue(TEXT("Trunks were placed"), TrunkBlocks > 0);
+	TestTrue(TEXT("Leaves were placed"), LeavesBlocks > 0);
+	return !HasAnyErrors();
+}
+
+#endif
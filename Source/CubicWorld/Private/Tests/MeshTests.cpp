@@ -0,0 +1,239 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+// Greedy mesher checks and timings, for example
+// UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests CubicWorld.Mesh; Quit"
+
+#include "Mesh/RuntimeMeshProviderChunk.h"
+#include "World/Chunk.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Meshing runs per fixture for the timing
+	constexpr int32 Iterations = 20;
+	constexpr int32 BlockTypeCount = 3;
+
+	FWorldConfig MakeWorldConfig()
+	{
+		FWorldConfig WorldConfig;
+		WorldConfig.Material = nullptr;
+		for (int32 Index = 0; Index < BlockTypeCount; ++Index)
+		{
+			WorldConfig.BlockTypes.AddDefaulted_GetRef().BlockName = FString::Printf(TEXT("Block%d"), Index);
+		}
+		return WorldConfig;
+	}
+
+	struct FMeshFixture
+	{
+		FString Name;
+		TFunction<FBlock(const FIntVector&, FRandomStream&)> GetBlock;
+		// Fills the six neighbors with the same blocks, so faces on the chunk border are culled
+		bool bWithNeighbors = false;
+	};
+
+	TArray<FMeshFixture> MakeFixtures(const FIntVector& InChunkSize)
+	{
+		return {
+			{TEXT("Empty"), [](const FIntVector&, FRandomStream&) { return Air; }},
+			{TEXT("Full"), [](const FIntVector&, FRandomStream&) { return FBlock(0); }},
+			{TEXT("FullWithNeighbors"), [](const FIntVector&, FRandomStream&) { return FBlock(0); }, true},
+			{TEXT("Checkerboard"), [](const FIntVector& Position, FRandomStream&)
+			{
+				return (Position.X + Position.Y + Position.Z) % 2 == 0 ? FBlock(0) : Air;
+			}},
+			{TEXT("TerrainSlice"), [InChunkSize](const FIntVector& Position, FRandomStream&)
+			{
+				const float Height = InChunkSize.Z * (0.5f + 0.25f * FMath::Sin(Position.X * 0.4f) * FMath::Cos(Position.Y * 0.3f));
+				if(Position.Z > Height) return Air;
+				return FBlock(Position.Z + 1 > Height ? 1 : (Position.Z < Height - 3 ? 2 : 0));
+			}},
+			{TEXT("Random"), [](const FIntVector&, FRandomStream& Random)
+			{
+				return Random.FRand() < 0.5f ? Air : FBlock(Random.RandHelper(BlockTypeCount));
+			}},
+		};
+	}
+
+	bool IsMeshed(const FBlock& InBlock)
+	{
+		return InBlock != Air && InBlock.BlockTypeID < BlockTypeCount;
+	}
+
+	/**
+	 * Compares the quads of the greedy mesh with the faces a naive mesher emits, one per meshed block side facing air.
+	 * Every face has to be covered by exactly one quad and quads must not cover anything else.
+	 */
+	bool CheckMesh(const UChunk* InChunk, const FRuntimeMeshRenderableMeshData& InMeshData, FString& OutError)
+	{
+		const FWorldConfig& WorldConfig = InChunk->GetChunkConfig().WorldConfig;
+		const FIntVector& ChunkSize = WorldConfig.ChunkSize;
+		static const FIntVector Directions[3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+
+		// Looked up separately from UChunk::GetBlock, so a wrong border lookup shows up as a difference
+		auto GetBlock = [&](const FIntVector& InPosition) -> FBlock
+		{
+			FIntVector ChunkOffset(0);
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				ChunkOffset[Axis] = InPosition[Axis] < 0 ? -1 : (InPosition[Axis] >= ChunkSize[Axis] ? 1 : 0);
+			}
+			if(UChunk* const* chunk = InChunk->WorldChunks->Find(InChunk->GetChunkConfig().Position + ChunkOffset); chunk != nullptr && *chunk != nullptr)
+			{
+				return (*chunk)->GetBlocks().GetBlock(InPosition - FIntVector(ChunkOffset.X * ChunkSize.X, ChunkOffset.Y * ChunkSize.Y, ChunkOffset.Z * ChunkSize.Z));
+			}
+			return Air;
+		};
+
+		// Faces as the block and the direction its side faces
+		TSet<TPair<FIntVector, FIntVector>> Faces;
+		for (int32 Z = 0; Z < ChunkSize.Z; ++Z)
+		{
+			for (int32 Y = 0; Y < ChunkSize.Y; ++Y)
+			{
+				for (int32 X = 0; X < ChunkSize.X; ++X)
+				{
+					const FIntVector Position(X, Y, Z);
+					if(!IsMeshed(GetBlock(Position))) continue;
+					for (const FIntVector& Direction : Directions)
+					{
+						if(GetBlock(Position + Direction) == Air) Faces.Add({Position, Direction});
+						if(GetBlock(Position - Direction) == Air) Faces.Add({Position, -Direction});
+					}
+				}
+			}
+		}
+
+		if(InMeshData.Positions.Num() % 4 != 0 || InMeshData.Triangles.Num() != InMeshData.Positions.Num() / 4 * 6)
+		{
+			OutError = FString::Printf(TEXT("%d vertices and %d indices are not whole quads"), InMeshData.Positions.Num(), InMeshData.Triangles.Num());
+			return false;
+		}
+
+		// Vertices are relative to the bottom center of the chunk
+		const FVector Offset(WorldConfig.GetChunkWorldSize().X / 2, WorldConfig.GetChunkWorldSize().Y / 2, 0);
+		TSet<TPair<FIntVector, FIntVector>> Covered;
+		for (int32 Quad = 0; Quad < InMeshData.Positions.Num() / 4; ++Quad)
+		{
+			FIntVector Min(MAX_int32), Max(MIN_int32);
+			for (int32 Corner = 0; Corner < 4; ++Corner)
+			{
+				const FVector Position = (FVector(InMeshData.Positions.GetPosition(Quad * 4 + Corner)) + Offset) / WorldConfig.BlockSize;
+				for (int32 Axis = 0; Axis < 3; ++Axis)
+				{
+					Min[Axis] = FMath::Min(Min[Axis], FMath::RoundToInt(Position[Axis]));
+					Max[Axis] = FMath::Max(Max[Axis], FMath::RoundToInt(Position[Axis]));
+				}
+			}
+			int32 PlaneAxis = INDEX_NONE;
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				if(Min[Axis] == Max[Axis]) PlaneAxis = Axis;
+			}
+			if(PlaneAxis == INDEX_NONE)
+			{
+				OutError = FString::Printf(TEXT("quad %d from %s to %s is not axis aligned"), Quad, *Min.ToString(), *Max.ToString());
+				return false;
+			}
+
+			// Each cell of the quad is the face of the block on one side of the plane, facing the air on the other
+			const FIntVector& Direction = Directions[PlaneAxis];
+			const int32 AxisU = (PlaneAxis + 1) % 3;
+			const int32 AxisV = (PlaneAxis + 2) % 3;
+			FIntVector Cell = Min;
+			for (Cell[AxisV] = Min[AxisV]; Cell[AxisV] < Max[AxisV]; ++Cell[AxisV])
+			{
+				for (Cell[AxisU] = Min[AxisU]; Cell[AxisU] < Max[AxisU]; ++Cell[AxisU])
+				{
+					const TPair<FIntVector, FIntVector> Below(Cell - Direction, Direction);
+					const TPair<FIntVector, FIntVector> Above(Cell, -Direction);
+					const TPair<FIntVector, FIntVector>& Face = Faces.Contains(Below) ? Below : Above;
+					if(!Faces.Contains(Face))
+					{
+						OutError = FString::Printf(TEXT("quad %d covers %s which is no visible face"), Quad, *Cell.ToString());
+						return false;
+					}
+					bool bIsAlreadyCovered = false;
+					Covered.Add(Face, &bIsAlreadyCovered);
+					if(bIsAlreadyCovered)
+					{
+						OutError = FString::Printf(TEXT("quad %d covers the face of %s again"), Quad, *Face.Key.ToString());
+						return false;
+					}
+				}
+			}
+		}
+		if(Covered.Num() != Faces.Num())
+		{
+			OutError = FString::Printf(TEXT("%d of %d faces are not covered"), Faces.Num() - Covered.Num(), Faces.Num());
+			return false;
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGreedyMesherTest, "CubicWorld.Mesh.GreedyMesher", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGreedyMesherTest::RunTest(const FString& Parameters)
+{
+	const FWorldConfig WorldConfig = MakeWorldConfig();
+	AddInfo(FString::Printf(TEXT("Meshing %s chunks, %d iterations each"), *WorldConfig.ChunkSize.ToString(), Iterations));
+
+	for (const FMeshFixture& Fixture : MakeFixtures(WorldConfig.ChunkSize))
+	{
+		TMap<FIntVector, UChunk*> WorldChunks;
+		TArray<TStrongObjectPtr<UChunk>> Chunks;
+		TArray<FIntVector> Positions = {FIntVector(0)};
+		if(Fixture.bWithNeighbors)
+		{
+			Positions.Append({{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}});
+		}
+		for (const FIntVector& Position : Positions)
+		{
+			UChunk* chunk = NewObject<UChunk>();
+			chunk->SetChunkConfig(FChunkConfig(WorldConfig, Position));
+			chunk->WorldChunks = &WorldChunks;
+			TChunkData& blocks = chunk->GetMutableBlocks();
+			FRandomStream Random(GetTypeHash(Fixture.Name));
+			for (int32 Z = 0; Z < WorldConfig.ChunkSize.Z; ++Z)
+			{
+				for (int32 Y = 0; Y < WorldConfig.ChunkSize.Y; ++Y)
+				{
+					for (int32 X = 0; X < WorldConfig.ChunkSize.X; ++X)
+					{
+						blocks.SetBlock(FIntVector(X, Y, Z), Fixture.GetBlock(FIntVector(X, Y, Z), Random));
+					}
+				}
+			}
+			chunk->bIsReady = true;
+			WorldChunks.Add(Position, chunk);
+			Chunks.Emplace(chunk);
+		}
+
+		const TStrongObjectPtr<URuntimeMeshProviderChunk> Provider(NewObject<URuntimeMeshProviderChunk>());
+		Provider->SetChunk(WorldChunks[FIntVector(0)]);
+
+		FRuntimeMeshRenderableMeshData MeshData;
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			MeshData = FRuntimeMeshRenderableMeshData();
+			Provider->GetMeshData(MeshData);
+		}
+		const double Microseconds = (FPlatformTime::Seconds() - Start) * 1e6 / Iterations;
+
+		FString Error;
+		if(!CheckMesh(WorldChunks[FIntVector(0)], MeshData, Error))
+		{
+			AddError(FString::Printf(TEXT("%s: mesh differs from the naive mesher, %s"), *Fixture.Name, *Error));
+		}
+		AddInfo(FString::Printf(TEXT("%s: %d quads, %d vertices, %.1f us per chunk"),
+			*Fixture.Name, MeshData.Positions.Num() / 4, MeshData.Positions.Num(), Microseconds));
+	}
+	return !HasAnyErrors();
+}
+
+#endif
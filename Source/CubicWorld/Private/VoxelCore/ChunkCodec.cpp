@@ -0,0 +1,89 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VoxelCore/ChunkCodec.h"
+
+namespace VoxelCore
+{
+	namespace
+	{
+		constexpr size_t HeaderSize = 3 * sizeof(int32_t);
+		constexpr size_t RunSize = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t);
+		// Keeps the block count in an int32, real chunks are far below it
+		constexpr uint64_t MaxBlocks = INT32_MAX;
+
+		void WriteUInt32(std::vector<uint8_t>& Data, const uint32_t Value)
+		{
+			for (int32_t Byte = 0; Byte < 4; ++Byte)
+			{
+				Data.push_back(static_cast<uint8_t>(Value >> (Byte * 8)));
+			}
+		}
+
+		uint32_t ReadUInt32(const uint8_t* Data)
+		{
+			return Data[0] | Data[1] << 8 | Data[2] << 16 | static_cast<uint32_t>(Data[3]) << 24;
+		}
+	}
+
+	FChunkEncoder::FChunkEncoder(const int32_t InSizeX, const int32_t InSizeY, const int32_t InSizeZ)
+	{
+		for (const int32_t Size : {InSizeX, InSizeY, InSizeZ})
+		{
+			WriteUInt32(Data, static_cast<uint32_t>(Size));
+		}
+	}
+
+	void FChunkEncoder::Add(const FRunBlock& InBlock)
+	{
+		if(Run.Count != 0 && Run.Block != InBlock)
+		{
+			WriteRun();
+		}
+		Run.Block = InBlock;
+		Run.Count++;
+	}
+
+	std::vector<uint8_t> FChunkEncoder::Finish()
+	{
+		if(Run.Count != 0)
+		{
+			WriteRun();
+		}
+		return std::move(Data);
+	}
+
+	void FChunkEncoder::WriteRun()
+	{
+		WriteUInt32(Data, Run.Count);
+		Data.push_back(Run.Block.BlockTypeId);
+		WriteUInt32(Data, Run.Block.bIsVisible ? 1 : 0);
+		Run = FBlockRun();
+	}
+
+	bool DecodeChunk(const uint8_t* InData, const size_t InNum, int32_t OutSize[3], std::vector<FBlockRun>& OutRuns)
+	{
+		if(InNum < HeaderSize) return false;
+		uint64_t BlockCount = 1;
+		for (int32_t Axis = 0; Axis < 3; ++Axis)
+		{
+			OutSize[Axis] = static_cast<int32_t>(ReadUInt32(InData + Axis * sizeof(int32_t)));
+			if(OutSize[Axis] <= 0) return false;
+			BlockCount *= static_cast<uint64_t>(OutSize[Axis]);
+			if(BlockCount > MaxBlocks) return false;
+		}
+		if((InNum - HeaderSize) % RunSize != 0) return false;
+
+		uint64_t Decoded = 0;
+		for (size_t Offset = HeaderSize; Offset < InNum; Offset += RunSize)
+		{
+			FBlockRun& run = OutRuns.emplace_back();
+			run.Count = ReadUInt32(InData + Offset);
+			run.Block.BlockTypeId = InData[Offset + sizeof(uint32_t)];
+			run.Block.bIsVisible = ReadUInt32(InData + Offset + sizeof(uint32_t) + sizeof(uint8_t)) != 0;
+			Decoded += run.Count;
+			if(run.Count == 0 || Decoded > BlockCount) return false;
+		}
+		return Decoded == BlockCount;
+	}
+}
@@ -0,0 +1,232 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VoxelCore/GreedyMesher.h"
+#include <algorithm>
+
+namespace VoxelCore
+{
+	namespace
+	{
+		const FRunBlock Air;
+
+		struct FSideInfo
+		{
+			int32_t NormalAxis;
+			int32_t Direction;
+			// Axes along the face, quads grow along U first. Also the axes of the ambient occlusion corners
+			int32_t AxisU;
+			int32_t AxisV;
+			// Corners of the block in vertex order, 1 is X, 2 is Y and 4 is Z
+			uint8_t Corners[4];
+		};
+
+		const FSideInfo SideInfos[MeshSideCount] = {
+			{2, 1, 0, 1, {6, 4, 5, 7}},
+			{2, -1, 0, 1, {0, 2, 3, 1}},
+			{1, 1, 0, 2, {2, 6, 7, 3}},
+			{1, -1, 0, 2, {1, 5, 4, 0}},
+			{0, 1, 1, 2, {3, 7, 5, 1}},
+			{0, -1, 1, 2, {0, 4, 6, 2}},
+		};
+
+		// The chunk with a one block border, so no lookup has to check the chunk bounds
+		class FPaddedChunk
+		{
+		public:
+			explicit FPaddedChunk(const FMesherInput& InInput)
+			{
+				for (int32_t Axis = 0; Axis < 3; ++Axis)
+				{
+					Size[Axis] = InInput.Size[Axis] + 2;
+				}
+				const size_t Num = static_cast<size_t>(Size[0]) * Size[1] * Size[2];
+				Blocks.resize(Num, Air);
+				Light.resize(Num, 0);
+
+				size_t Index = 0;
+				for (int32_t Z = -1; Z <= InInput.Size[2]; ++Z)
+				{
+					for (int32_t Y = -1; Y <= InInput.Size[1]; ++Y)
+					{
+						for (int32_t X = -1; X <= InInput.Size[0]; ++X, ++Index)
+						{
+							if(X >= 0 && X < InInput.Size[0] && Y >= 0 && Y < InInput.Size[1] && Z >= 0 && Z < InInput.Size[2])
+							{
+								const size_t ChunkIndex = (static_cast<size_t>(Z) * InInput.Size[1] + Y) * InInput.Size[0] + X;
+								Blocks[Index] = InInput.Blocks[ChunkIndex];
+								Light[Index] = InInput.Light != nullptr ? InInput.Light[ChunkIndex] : 0;
+							}
+							else if(InInput.GetBorder)
+							{
+								uint8_t BorderLight = 0;
+								InInput.GetBorder(X, Y, Z, Blocks[Index], BorderLight);
+								Light[Index] = InInput.Light != nullptr ? BorderLight : 0;
+							}
+						}
+					}
+				}
+			}
+
+			const FRunBlock& GetBlock(const int32_t InPosition[3]) const
+			{
+				return Blocks[GetIndex(InPosition)];
+			}
+
+			uint8_t GetLight(const int32_t InPosition[3]) const
+			{
+				return Light[GetIndex(InPosition)];
+			}
+
+		private:
+			int32_t Size[3];
+			std::vector<FRunBlock> Blocks;
+			std::vector<uint8_t> Light;
+
+			size_t GetIndex(const int32_t InPosition[3]) const
+			{
+				return (static_cast<size_t>(InPosition[2] + 1) * Size[1] + InPosition[1] + 1) * Size[0] + InPosition[0] + 1;
+			}
+		};
+
+		// Two bits per corner of the face in front of InFront, corner 1 is +U and corner 2 is +V
+		uint8_t GetAmbientOcclusion(const FPaddedChunk& InChunk, const int32_t InFront[3], const FSideInfo& InSide)
+		{
+			uint8_t AmbientOcclusion = 0;
+			for (int32_t Corner = 0; Corner < 4; ++Corner)
+			{
+				int32_t SideA[3] = {InFront[0], InFront[1], InFront[2]};
+				int32_t SideB[3] = {InFront[0], InFront[1], InFront[2]};
+				SideA[InSide.AxisU] += Corner & 1 ? 1 : -1;
+				SideB[InSide.AxisV] += Corner & 2 ? 1 : -1;
+				int32_t Diagonal[3] = {SideA[0], SideA[1], SideA[2]};
+				Diagonal[InSide.AxisV] = SideB[InSide.AxisV];
+				const bool bSideA = InChunk.GetBlock(SideA) != Air;
+				const bool bSideB = InChunk.GetBlock(SideB) != Air;
+				const bool bCorner = InChunk.GetBlock(Diagonal) != Air;
+				const uint8_t Value = bSideA && bSideB ? 0 : static_cast<uint8_t>(3 - (bSideA + bSideB + bCorner));
+				AmbientOcclusion |= Value << (Corner * 2);
+			}
+			return AmbientOcclusion;
+		}
+
+		// Faces only merge with equal keys, 0 is no face
+		uint32_t MakeFaceKey(const FRunBlock& InBlock, const uint8_t InLight, const uint8_t InAmbientOcclusion)
+		{
+			return 1u << 31 | static_cast<uint32_t>(InBlock.BlockTypeId) << 17 | static_cast<uint32_t>(InBlock.bIsVisible) << 16
+				| static_cast<uint32_t>(InLight) << 8 | InAmbientOcclusion;
+		}
+
+		void AddQuad(FSideMesh& OutMesh, const FSideInfo& InSide, const FMeshQuad& InQuad)
+		{
+			const uint32_t First = static_cast<uint32_t>(OutMesh.Positions.size() / 3);
+			uint8_t Occlusion[4];
+			for (int32_t Vertex = 0; Vertex < 4; ++Vertex)
+			{
+				const uint8_t Corner = InSide.Corners[Vertex];
+				for (int32_t Axis = 0; Axis < 3; ++Axis)
+				{
+					const bool bIsMax = Corner & (1 << Axis);
+					OutMesh.Positions.push_back(static_cast<float>(bIsMax ? InQuad.Max[Axis] + 1 : InQuad.Min[Axis]));
+				}
+				const int32_t AmbientOcclusionCorner = (Corner & (1 << InSide.AxisU) ? 1 : 0) | (Corner & (1 << InSide.AxisV) ? 2 : 0);
+				Occlusion[Vertex] = (InQuad.AmbientOcclusion >> (AmbientOcclusionCorner * 2)) & 0x03;
+				OutMesh.VertexOcclusion.push_back(Occlusion[Vertex]);
+			}
+
+			// Split along the brighter diagonal so occlusion does not stretch across the quad
+			const uint32_t Triangles[2][6] = {{0, 2, 1, 0, 3, 2}, {0, 3, 1, 1, 3, 2}};
+			for (const uint32_t Index : Triangles[Occlusion[0] + Occlusion[2] < Occlusion[1] + Occlusion[3] ? 1 : 0])
+			{
+				OutMesh.Indices.push_back(First + Index);
+			}
+			OutMesh.Quads.push_back(InQuad);
+		}
+	}
+
+	void FSideMesh::Reset()
+	{
+		Quads.clear();
+		Positions.clear();
+		VertexOcclusion.clear();
+		Indices.clear();
+	}
+
+	void GreedyMesh(const FMesherInput& InInput, FSideMesh OutMeshes[MeshSideCount])
+	{
+		for (int32_t Side = 0; Side < MeshSideCount; ++Side)
+		{
+			OutMeshes[Side].Reset();
+		}
+		if(InInput.Blocks == nullptr || InInput.Size[0] <= 0 || InInput.Size[1] <= 0 || InInput.Size[2] <= 0) return;
+
+		const FPaddedChunk Chunk(InInput);
+		std::vector<uint32_t> Mask;
+		for (int32_t Side = 0; Side < MeshSideCount; ++Side)
+		{
+			const FSideInfo& Info = SideInfos[Side];
+			const int32_t SizeU = InInput.Size[Info.AxisU];
+			const int32_t SizeV = InInput.Size[Info.AxisV];
+			Mask.assign(static_cast<size_t>(SizeU) * SizeV, 0);
+			for (int32_t Slice = 0; Slice < InInput.Size[Info.NormalAxis]; ++Slice)
+			{
+				// Visible faces of the slice
+				int32_t Position[3];
+				Position[Info.NormalAxis] = Slice;
+				for (int32_t V = 0; V < SizeV; ++V)
+				{
+					for (int32_t U = 0; U < SizeU; ++U)
+					{
+						Position[Info.AxisU] = U;
+						Position[Info.AxisV] = V;
+						uint32_t& Key = Mask[static_cast<size_t>(V) * SizeU + U];
+						Key = 0;
+						const FRunBlock& Block = Chunk.GetBlock(Position);
+						if(Block == Air || Block.BlockTypeId >= InInput.BlockTypeCount) continue;
+						int32_t Front[3] = {Position[0], Position[1], Position[2]};
+						Front[Info.NormalAxis] += Info.Direction;
+						if(Chunk.GetBlock(Front) != Air) continue;
+						Key = MakeFaceKey(Block, Chunk.GetLight(Front), InInput.bAmbientOcclusion ? GetAmbientOcclusion(Chunk, Front, Info) : 0xFF);
+					}
+				}
+
+				// Widest run along U first, then as many rows of it along V as match
+				for (int32_t V = 0; V < SizeV; ++V)
+				{
+					for (int32_t U = 0; U < SizeU; ++U)
+					{
+						const uint32_t Key = Mask[static_cast<size_t>(V) * SizeU + U];
+						if(Key == 0) continue;
+						int32_t Width = 1;
+						while (U + Width < SizeU && Mask[static_cast<size_t>(V) * SizeU + U + Width] == Key) ++Width;
+						int32_t Height = 1;
+						for (; V + Height < SizeV; ++Height)
+						{
+							const uint32_t* Row = &Mask[static_cast<size_t>(V + Height) * SizeU + U];
+							int32_t Matching = 0;
+							while (Matching < Width && Row[Matching] == Key) ++Matching;
+							if(Matching < Width) break;
+						}
+						for (int32_t Row = 0; Row < Height; ++Row)
+						{
+							std::fill_n(&Mask[static_cast<size_t>(V + Row) * SizeU + U], Width, 0u);
+						}
+
+						FMeshQuad Quad;
+						Quad.Min[Info.NormalAxis] = Quad.Max[Info.NormalAxis] = Slice;
+						Quad.Min[Info.AxisU] = U;
+						Quad.Max[Info.AxisU] = U + Width - 1;
+						Quad.Min[Info.AxisV] = V;
+						Quad.Max[Info.AxisV] = V + Height - 1;
+						Quad.Side = static_cast<EMeshSide>(Side);
+						Quad.Block.BlockTypeId = static_cast<uint8_t>(Key >> 17);
+						Quad.Block.bIsVisible = (Key >> 16 & 1) != 0;
+						Quad.Light = static_cast<uint8_t>(Key >> 8);
+						Quad.AmbientOcclusion = static_cast<uint8_t>(Key);
+						AddQuad(OutMeshes[Side], Info, Quad);
+					}
+				}
+			}
+		}
+	}
+}
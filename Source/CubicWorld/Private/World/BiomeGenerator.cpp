@@ -0,0 +1,216 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/BiomeGenerator.h"
+#include "Globals.h"
+
+DECLARE_CYCLE_STAT(TEXT("Generate biome chunk"), STAT_BiomeGenerator, STATGROUP_CubicWorld);
+DECLARE_CYCLE_STAT(TEXT("Build biome region"), STAT_BuildBiomeRegion, STATGROUP_CubicWorld);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cached biome regions"), STAT_CachedBiomeRegions, STATGROUP_CubicWorld);
+
+namespace
+{
+	// The cache is cleared when it grows past this, regions in use are kept alive by their generators
+	constexpr int32 MaxCachedRegions = 256;
+
+	void ConfigureNoise(FastNoiseLite& Noise, const FNoiseConfig& Config)
+	{
+		Noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+		Noise.SetFractalType(FastNoiseLite::FractalType_FBm);
+		Noise.SetSeed(Config.Seed);
+		Noise.SetFrequency(Config.Frequency);
+		Noise.SetFractalGain(Config.Gain);
+		Noise.SetFractalOctaves(Config.Octaves);
+		Noise.SetFractalLacunarity(Config.Lacunarity);
+	}
+}
+
+UBiomeGenerator::UBiomeGenerator()
+{
+	// Climate changes over hundreds of blocks
+	TemperatureNoiseConfig.Seed = 1341;
+	TemperatureNoiseConfig.Frequency = 0.002f;
+	TemperatureNoiseConfig.Octaves = 2;
+	HumidityNoiseConfig.Seed = 1342;
+	HumidityNoiseConfig.Frequency = 0.002f;
+	HumidityNoiseConfig.Octaves = 2;
+}
+
+void UBiomeGenerator::Init()
+{
+	ConfigureNoise(TemperatureNoise, TemperatureNoiseConfig);
+	ConfigureNoise(HumidityNoise, HumidityNoiseConfig);
+	BiomeNoises.SetNum(Biomes.Num());
+	for (int32 Index = 0; Index < Biomes.Num(); ++Index)
+	{
+		ConfigureNoise(BiomeNoises[Index], Biomes[Index].NoiseConfig);
+		Biomes[Index].Layers.Sort([](const FBlockLayer& A, const FBlockLayer& B)
+		{
+			return A.Height < B.Height;
+		});
+	}
+	{
+		FScopeLock Lock(&RegionsSyncRoot);
+		Regions.Reset();
+	}
+	bHasBeenInitialized = true;
+}
+
+int32 UBiomeGenerator::GetRegionBlocks() const
+{
+	const int32 Spacing = FMath::Max(1, SampleSpacing);
+	return FMath::Max(1, RegionSize / Spacing) * Spacing;
+}
+
+UBiomeGenerator::FBiomeRegionPtr UBiomeGenerator::GetRegion(const FIntPoint& InRegionPosition, const float InMaxHeight)
+{
+	{
+		FScopeLock Lock(&RegionsSyncRoot);
+		if(const FBiomeRegionPtr* region = Regions.Find(InRegionPosition))
+		{
+			return *region;
+		}
+	}
+	// Built outside of the lock, two chunks building the same region get the same result
+	FBiomeRegionPtr region = BuildRegion(InRegionPosition, InMaxHeight);
+	FScopeLock Lock(&RegionsSyncRoot);
+	if(Regions.Num() >= MaxCachedRegions)
+	{
+		Regions.Reset();
+	}
+	Regions.Add(InRegionPosition, region);
+	SET_DWORD_STAT(STAT_CachedBiomeRegions, Regions.Num());
+	return region;
+}
+
+UBiomeGenerator::FBiomeRegionPtr UBiomeGenerator::BuildRegion(const FIntPoint& InRegionPosition, const float InMaxHeight)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BuildBiomeRegion);
+	const int32 Spacing = FMath::Max(1, SampleSpacing);
+	const int32 RegionBlocks = GetRegionBlocks();
+	const FIntPoint Origin = InRegionPosition * RegionBlocks;
+
+	const TSharedRef<FBiomeRegion, ESPMode::ThreadSafe> region = MakeShared<FBiomeRegion, ESPMode::ThreadSafe>();
+	region->SamplesPerSide = RegionBlocks / Spacing + 1;
+	const int32 SampleNum = region->SamplesPerSide * region->SamplesPerSide;
+
+	TArray<float> Temperatures;
+	TArray<float> Humidities;
+	TArray<float> BiomeHeights;
+	Temperatures.SetNumUninitialized(SampleNum);
+	Humidities.SetNumUninitialized(SampleNum);
+	BiomeHeights.SetNumUninitialized(SampleNum * Biomes.Num());
+	TemperatureNoise.GetNoiseGrid2D(Temperatures.GetData(), Origin.X, Origin.Y, region->SamplesPerSide, region->SamplesPerSide, Spacing);
+	HumidityNoise.GetNoiseGrid2D(Humidities.GetData(), Origin.X, Origin.Y, region->SamplesPerSide, region->SamplesPerSide, Spacing);
+	for (int32 Biome = 0; Biome < Biomes.Num(); ++Biome)
+	{
+		float* heights = &BiomeHeights[Biome * SampleNum];
+		BiomeNoises[Biome].GetNoiseGrid2D(heights, Origin.X, Origin.Y, region->SamplesPerSide, region->SamplesPerSide, Spacing);
+		for (int32 Sample = 0; Sample < SampleNum; ++Sample)
+		{
+			const float height = FMath::Pow(heights[Sample] / 2.0f + 0.5f, Biomes[Biome].NoiseConfig.Power);
+			heights[Sample] = FMath::Lerp(Biomes[Biome].MinHeight, Biomes[Biome].MaxHeight, height) * InMaxHeight;
+		}
+	}
+
+	region->Heights.SetNumUninitialized(SampleNum);
+	region->Weights.SetNumUninitialized(SampleNum * Biomes.Num());
+	TArray<float> Distances;
+	Distances.SetNumUninitialized(Biomes.Num());
+	for (int32 Sample = 0; Sample < SampleNum; ++Sample)
+	{
+		float minDistance = MAX_flt;
+		for (int32 Biome = 0; Biome < Biomes.Num(); ++Biome)
+		{
+			Distances[Biome] = FVector2f(Temperatures[Sample] - Biomes[Biome].Temperature, Humidities[Sample] - Biomes[Biome].Humidity).Size();
+			minDistance = FMath::Min(minDistance, Distances[Biome]);
+		}
+		// The closest biome has weight 1 before normalizing, the others fade out over the blend distance
+		float weightSum = 0;
+		float height = 0;
+		for (int32 Biome = 0; Biome < Biomes.Num(); ++Biome)
+		{
+			const float weight = FMath::Square(FMath::Max(0.0f, 1.0f - (Distances[Biome] - minDistance) / BlendDistance));
+			region->Weights[Sample * Biomes.Num() + Biome] = weight;
+			weightSum += weight;
+			height += weight * BiomeHeights[Biome * SampleNum + Sample];
+		}
+		region->Heights[Sample] = height / weightSum;
+		for (int32 Biome = 0; Biome < Biomes.Num(); ++Biome)
+		{
+			region->Weights[Sample * Biomes.Num() + Biome] /= weightSum;
+		}
+	}
+	return region;
+}
+
+void UBiomeGenerator::GenerateChunk(const FChunkConfig& ChunkConfig, TChunkData& Blocks)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BiomeGenerator);
+	if(!bHasBeenInitialized) Init();
+	if(Biomes.IsEmpty()) return;
+
+	const FIntVector& ChunkSize = ChunkConfig.WorldConfig.ChunkSize;
+	const FIntVector ChunkOrigin = ChunkConfig.GetChunkPositionInBlocks();
+	const int32 MaxHeight = ChunkConfig.WorldConfig.GetWorldBlockHeight();
+	const int32 Spacing = FMath::Max(1, SampleSpacing);
+	const int32 RegionBlocks = GetRegionBlocks();
+
+	// Surface height and biome of every column, interpolated between the region samples
+	TArray<int32> Heights;
+	TArray<int32> ColumnBiomes;
+	Heights.SetNumUninitialized(ChunkSize.X * ChunkSize.Y);
+	ColumnBiomes.SetNumUninitialized(ChunkSize.X * ChunkSize.Y);
+	FIntPoint regionPosition(MAX_int32);
+	FBiomeRegionPtr region;
+	for (int32 Y = 0; Y < ChunkSize.Y; ++Y)
+	{
+		for (int32 X = 0; X < ChunkSize.X; ++X)
+		{
+			const FIntPoint WorldPosition(ChunkOrigin.X + X, ChunkOrigin.Y + Y);
+			if(const FIntPoint position(FloorDivide(WorldPosition.X, RegionBlocks), FloorDivide(WorldPosition.Y, RegionBlocks)); position != regionPosition)
+			{
+				regionPosition = position;
+				region = GetRegion(position, MaxHeight);
+			}
+			const FIntPoint Local = WorldPosition - regionPosition * RegionBlocks;
+			const int32 X0 = Local.X / Spacing;
+			const int32 Y0 = Local.Y / Spacing;
+			const float AlphaX = static_cast<float>(Local.X % Spacing) / Spacing;
+			const float AlphaY = static_cast<float>(Local.Y % Spacing) / Spacing;
+			const int32 Sample00 = Y0 * region->SamplesPerSide + X0;
+			const int32 Sample10 = Sample00 + 1;
+			const int32 Sample01 = Sample00 + region->SamplesPerSide;
+			const int32 Sample11 = Sample01 + 1;
+			auto Bilinear = [&](const TArray<float>& Values, const int32 Stride, const int32 Offset)
+			{
+				return FMath::Lerp(
+					FMath::Lerp(Values[Sample00 * Stride + Offset], Values[Sample10 * Stride + Offset], AlphaX),
+					FMath::Lerp(Values[Sample01 * Stride + Offset], Values[Sample11 * Stride + Offset], AlphaX),
+					AlphaY);
+			};
+
+			const int32 Index = Y * ChunkSize.X + X;
+			Heights[Index] = FMath::RoundToInt(Bilinear(region->Heights, 1, 0));
+			float maxWeight = -1;
+			for (int32 Biome = 0; Biome < Biomes.Num(); ++Biome)
+			{
+				if(const float weight = Bilinear(region->Weights, Biomes.Num(), Biome); weight > maxWeight)
+				{
+					maxWeight = weight;
+					ColumnBiomes[Index] = Biome;
+				}
+			}
+		}
+	}
+	if(ChunkOrigin.Z > FMath::Max(Heights)) return;
+
+	for (int32 Y = 0; Y < ChunkSize.Y; ++Y)
+	{
+		for (int32 X = 0; X < ChunkSize.X; ++X)
+		{
+			const int32 Index = Y * ChunkSize.X + X;
+			USimpleGenerator::FillLayerColumn(ChunkConfig, Blocks, X, Y, Heights[Index], Biomes[ColumnBiomes[Index]].Layers);
+		}
+	}
+}
@@ -0,0 +1,9 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/BlockTickHandler.h"
+
+
+void UBlockTickHandler::OnBlockTick_Implementation(AWorldManager* InWorldManager, const FIntVector& InPosition, const FBlock& InBlock, bool bIsRandomTick)
+{
+}
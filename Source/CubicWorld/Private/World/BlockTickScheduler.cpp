@@ -0,0 +1,87 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/BlockTickScheduler.h"
+#include "Globals.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scheduled block ticks"), STAT_ScheduledBlockTicks, STATGROUP_CubicWorld);
+
+namespace
+{
+	bool OverflowPredicate(const FScheduledBlockTick& A, const FScheduledBlockTick& B)
+	{
+		return A.Tick < B.Tick;
+	}
+}
+
+FBlockTickScheduler::FBlockTickScheduler(const FWorldConfig& InWorldConfig) :
+	WorldConfig(InWorldConfig),
+	RandomStream(InWorldConfig.RandomTickSeed)
+{
+}
+
+void FBlockTickScheduler::Schedule(const FIntVector& InPosition, const uint8 InBlockTypeID, const int32 InDelay)
+{
+	const uint64 Tick = CurrentTick + FMath::Max(InDelay, 1);
+	if(const uint64* ScheduledTick = Scheduled.Find(InPosition); ScheduledTick != nullptr && *ScheduledTick <= Tick) return;
+
+	// The older entry stays in the wheel and is skipped when it comes up
+	Scheduled.Add(InPosition, Tick);
+	if(Tick - CurrentTick < WheelSize)
+	{
+		Wheel[Tick % WheelSize].Add({InPosition, InBlockTypeID, Tick});
+	} else
+	{
+		Overflow.HeapPush({InPosition, InBlockTypeID, Tick}, OverflowPredicate);
+	}
+}
+
+bool FBlockTickScheduler::IsScheduled(const FIntVector& InPosition) const
+{
+	return Scheduled.Contains(InPosition);
+}
+
+int32 FBlockTickScheduler::ConsumeSteps(const float InDeltaTime)
+{
+	const float StepTime = 1.0f / FMath::Max(WorldConfig.BlockTickRate, 1.0f);
+	// Drops the time the world can't catch up on instead of ticking forever after a hitch
+	Accumulator = FMath::Min(Accumulator + InDeltaTime, StepTime * MaxStepsPerUpdate);
+	const int32 Steps = FMath::FloorToInt(Accumulator / StepTime);
+	Accumulator -= Steps * StepTime;
+	return Steps;
+}
+
+void FBlockTickScheduler::Advance(TArray<FScheduledBlockTick>& OutDueTicks)
+{
+	CurrentTick++;
+	while (!Overflow.IsEmpty() && Overflow.HeapTop().Tick - CurrentTick < WheelSize)
+	{
+		FScheduledBlockTick Entry;
+		Overflow.HeapPop(Entry, OverflowPredicate);
+		Wheel[Entry.Tick % WheelSize].Add(Entry);
+	}
+
+	TArray<FScheduledBlockTick>& Slot = Wheel[CurrentTick % WheelSize];
+	for (const FScheduledBlockTick& Entry : Slot)
+	{
+		if(const uint64* ScheduledTick = Scheduled.Find(Entry.Position); ScheduledTick != nullptr && *ScheduledTick == Entry.Tick)
+		{
+			Scheduled.Remove(Entry.Position);
+			OutDueTicks.Add(Entry);
+		}
+	}
+	Slot.Reset();
+	SET_DWORD_STAT(STAT_ScheduledBlockTicks, Scheduled.Num());
+}
+
+void FBlockTickScheduler::SampleRandomTicks(const FIntVector& InChunkPosition, TArray<FIntVector>& OutPositions)
+{
+	const FIntVector ChunkSize = WorldConfig.ChunkSize;
+	const FIntVector Origin(InChunkPosition.X * ChunkSize.X, InChunkPosition.Y * ChunkSize.Y, InChunkPosition.Z * ChunkSize.Z);
+	for (int32 Index = 0; Index < WorldConfig.RandomTicksPerChunk; ++Index)
+	{
+		OutPositions.Add(Origin + FIntVector(RandomStream.RandHelper(ChunkSize.X),
+											 RandomStream.RandHelper(ChunkSize.Y),
+											 RandomStream.RandHelper(ChunkSize.Z)));
+	}
+}
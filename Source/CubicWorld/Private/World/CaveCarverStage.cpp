@@ -0,0 +1,61 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/CaveCarverStage.h"
+
+UCaveCarverStage::UCaveCarverStage()
+{
+	CaveNoiseConfig.Seed = 1339;
+	CaveNoiseConfig.Frequency = 0.015f;
+	CaveNoiseConfig.Octaves = 1;
+}
+
+void UCaveCarverStage::Init()
+{
+	for (FastNoiseLite* noise : {&FirstNoise, &SecondNoise})
+	{
+		noise->SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+		noise->SetFractalType(FastNoiseLite::FractalType_FBm);
+		noise->SetFrequency(CaveNoiseConfig.Frequency);
+		noise->SetFractalGain(CaveNoiseConfig.Gain);
+		noise->SetFractalOctaves(CaveNoiseConfig.Octaves);
+		noise->SetFractalLacunarity(CaveNoiseConfig.Lacunarity);
+	}
+	FirstNoise.SetSeed(CaveNoiseConfig.Seed);
+	SecondNoise.SetSeed(CaveNoiseConfig.Seed + 1);
+}
+
+bool UCaveCarverStage::ShouldGenerate(const FChunkConfig& ChunkConfig) const
+{
+	return Super::ShouldGenerate(ChunkConfig) &&
+		ChunkConfig.GetChunkPositionInBlocks().Z < MaxHeight * ChunkConfig.WorldConfig.GetWorldBlockHeight();
+}
+
+void UCaveCarverStage::Generate(const FChunkConfig& ChunkConfig, TChunkData& Blocks, const FGeneratorStageNeighbors& Neighbors)
+{
+	const FIntVector& ChunkSize = ChunkConfig.WorldConfig.ChunkSize;
+	const FIntVector ChunkOrigin = ChunkConfig.GetChunkPositionInBlocks();
+	const int32 MaxZ = MaxHeight * ChunkConfig.WorldConfig.GetWorldBlockHeight() - ChunkOrigin.Z;
+
+	TArray<float> First;
+	TArray<float> Second;
+	First.SetNumUninitialized(ChunkSize.X * ChunkSize.Y * ChunkSize.Z);
+	Second.SetNumUninitialized(First.Num());
+	FirstNoise.GetNoiseGrid3D(First.GetData(), ChunkOrigin.X, ChunkOrigin.Y, ChunkOrigin.Z, ChunkSize.X, ChunkSize.Y, ChunkSize.Z);
+	SecondNoise.GetNoiseGrid3D(Second.GetData(), ChunkOrigin.X, ChunkOrigin.Y, ChunkOrigin.Z, ChunkSize.X, ChunkSize.Y, ChunkSize.Z);
+
+	for (int32 Z = 0; Z < FMath::Min(ChunkSize.Z, MaxZ); ++Z)
+	{
+		for (int32 Y = 0; Y < ChunkSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < ChunkSize.X; ++X)
+			{
+				const int32 index = (Z * ChunkSize.Y + Y) * ChunkSize.X + X;
+				if(FMath::Abs(First[index]) < TunnelWidth && FMath::Abs(Second[index]) < TunnelWidth)
+				{
+					Blocks.RemoveBlock(FIntVector(X, Y, Z));
+				}
+			}
+		}
+	}
+}
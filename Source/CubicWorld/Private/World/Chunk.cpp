@@ -63,14 +63,123 @@ FBlock UChunk::GetBlock(const FIntVector& Position) const
 	return Blocks.GetBlock(Position);
 }
 
+uint8 UChunk::GetLight(const FIntVector& Position) const
+{
+	const FIntVector ChunkSize = ChunkConfig.WorldConfig.ChunkSize;
+	FIntVector ChunkOffset(0);
+	FIntVector LocalPosition = Position;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if(LocalPosition[Axis] < 0)
+		{
+			ChunkOffset[Axis] = -1;
+			LocalPosition[Axis] += ChunkSize[Axis];
+		} else if(LocalPosition[Axis] >= ChunkSize[Axis])
+		{
+			ChunkOffset[Axis] = 1;
+			LocalPosition[Axis] -= ChunkSize[Axis];
+		}
+	}
+	if(ChunkOffset == FIntVector(0))
+	{
+		return Blocks.GetLight(Position);
+	}
+	if(const auto chunk = WorldChunks->Find(ChunkConfig.Position+ChunkOffset); chunk != nullptr && *chunk != nullptr && (*chunk)->bIsReady)
+	{
+		return (*chunk)->Blocks.GetLight(LocalPosition);
+	}
+	return 0xF0;
+}
+
 void UChunk::SetBlocks(const TChunkData& InBlocks)
 {
 	Blocks = InBlocks;
 	bIsReady = true;
 }
 
-const TChunkData& UChunk::GetBlocks()
+const TChunkData& UChunk::GetBlocks() const
 {
 	return Blocks;
 }
 
+TChunkData& UChunk::GetMutableBlocks()
+{
+	return Blocks;
+}
+
+int32 UChunk::GetFacePairIndex(int32 InFaceA, int32 InFaceB)
+{
+	if(InFaceA > InFaceB) Swap(InFaceA, InFaceB);
+	return InFaceA * (11 - InFaceA) / 2 + InFaceB - InFaceA - 1;
+}
+
+void UChunk::UpdateFaceConnectivity()
+{
+	const FIntVector ChunkSize = ChunkConfig.WorldConfig.ChunkSize;
+	const TArray<FBlockType>& BlockTypes = ChunkConfig.WorldConfig.BlockTypes;
+	const auto GetIndex = [&ChunkSize](const FIntVector& InPosition)
+	{
+		return InPosition.X + InPosition.Y * ChunkSize.X + InPosition.Z * ChunkSize.X * ChunkSize.Y;
+	};
+	const auto IsOpen = [this, &BlockTypes](const FIntVector& InPosition)
+	{
+		const FBlock Block = Blocks.GetBlock(InPosition);
+		return Block == Air || !BlockTypes.IsValidIndex(Block.BlockTypeID) || !BlockTypes[Block.BlockTypeID].bIsSolid;
+	};
+	static const FIntVector Directions[6] = {{0,0,1}, {0,0,-1}, {0,1,0}, {0,-1,0}, {1,0,0}, {-1,0,0}};
+
+	FaceConnectivity = 0;
+	TBitArray<> Visited(false, ChunkSize.X * ChunkSize.Y * ChunkSize.Z);
+	TArray<FIntVector> Stack;
+	for (int Z = 0; Z < ChunkSize.Z; ++Z)
+	{
+		for (int Y = 0; Y < ChunkSize.Y; ++Y)
+		{
+			for (int X = 0; X < ChunkSize.X; ++X)
+			{
+				const FIntVector Start(X, Y, Z);
+				if(Visited[GetIndex(Start)] || !IsOpen(Start)) continue;
+
+				// Flood fill the open region and remember which faces it touches
+				uint8 Faces = 0;
+				Visited[GetIndex(Start)] = true;
+				Stack.Add(Start);
+				while (!Stack.IsEmpty())
+				{
+					const FIntVector Position = Stack.Pop();
+					if(Position.Z == ChunkSize.Z-1) Faces |= 1 << 0;
+					if(Position.Z == 0) Faces |= 1 << 1;
+					if(Position.Y == ChunkSize.Y-1) Faces |= 1 << 2;
+					if(Position.Y == 0) Faces |= 1 << 3;
+					if(Position.X == ChunkSize.X-1) Faces |= 1 << 4;
+					if(Position.X == 0) Faces |= 1 << 5;
+					for (const FIntVector& Direction : Directions)
+					{
+						const FIntVector Neighbor = Position + Direction;
+						if(Neighbor.X < 0 || Neighbor.Y < 0 || Neighbor.Z < 0 ||
+							Neighbor.X >= ChunkSize.X || Neighbor.Y >= ChunkSize.Y || Neighbor.Z >= ChunkSize.Z) continue;
+						if(Visited[GetIndex(Neighbor)] || !IsOpen(Neighbor)) continue;
+						Visited[GetIndex(Neighbor)] = true;
+						Stack.Add(Neighbor);
+					}
+				}
+
+				for (int32 FaceA = 0; FaceA < 6; ++FaceA)
+				{
+					for (int32 FaceB = FaceA + 1; FaceB < 6; ++FaceB)
+					{
+						if((Faces & (1 << FaceA)) && (Faces & (1 << FaceB)))
+						{
+							FaceConnectivity |= 1 << GetFacePairIndex(FaceA, FaceB);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+bool UChunk::AreFacesConnected(const int32 InFaceA, const int32 InFaceB) const
+{
+	return InFaceA == InFaceB || (FaceConnectivity & (1 << GetFacePairIndex(InFaceA, InFaceB))) != 0;
+}
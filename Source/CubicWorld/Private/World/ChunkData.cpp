@@ -6,9 +6,9 @@
 
 int32 TChunkData::GetBlockIndex(const FIntVector& Position) const
 {
-	if(	Position.X < 0 || Position.X > ChunkSize.X ||
-		Position.Y < 0 || Position.Y > ChunkSize.Y ||
-		Position.Z < 0 || Position.Z > ChunkSize.Z)
+	if(	Position.X < 0 || Position.X >= ChunkSize.X ||
+		Position.Y < 0 || Position.Y >= ChunkSize.Y ||
+		Position.Z < 0 || Position.Z >= ChunkSize.Z)
 	{
 		return -1;
 	}
@@ -38,6 +38,8 @@ bool TChunkData::SetBlock(const FIntVector& Position, const FBlock& Block)
 void TChunkData::SetBlocks(const TArray<FBlock>& InBlocks)
 {
 	Blocks = InBlocks;
+	Light.Init(0, Blocks.Num());
+	FluidLevels.Init(0, Blocks.Num());
 }
 
 const TArray<FBlock>& TChunkData::GetBlocks()
@@ -55,8 +57,70 @@ bool TChunkData::RemoveBlock(const FIntVector& Position)
 	return false;
 }
 
+int32 TChunkData::FillColumn(const int32 X, const int32 Y, const int32 MinZ, const int32 MaxZ, const FBlock& Block)
+{
+	if(X < 0 || X >= ChunkSize.X || Y < 0 || Y >= ChunkSize.Y) return 0;
+	const int32 layerSize = ChunkSize.X * ChunkSize.Y;
+	const int32 lastZ = FMath::Min(MaxZ, Blocks.Num() / layerSize - 1);
+	int32 filled = 0;
+	for (int32 Z = FMath::Max(MinZ, 0), index = Z * layerSize + Y * ChunkSize.X + X; Z <= lastZ; ++Z, index += layerSize)
+	{
+		if(Blocks[index] == Air)
+		{
+			Blocks[index] = Block;
+			filled++;
+		}
+	}
+	return filled;
+}
+
 bool TChunkData::IsEmpty() const
 {
 	return Blocks.Num() == 0;
 }
 
+uint8 TChunkData::GetLight(const FIntVector& Position) const
+{
+	const int32 index = GetBlockIndex(Position);
+	return index >= 0 && index < Light.Num() ? Light[index] : 0;
+}
+
+uint8 TChunkData::GetSkyLight(const FIntVector& Position) const
+{
+	return GetLight(Position) >> 4;
+}
+
+uint8 TChunkData::GetBlockLight(const FIntVector& Position) const
+{
+	return GetLight(Position) & 0x0F;
+}
+
+void TChunkData::SetSkyLight(const FIntVector& Position, const uint8 Level)
+{
+	if(const int32 index = GetBlockIndex(Position); index >= 0 && index < Light.Num())
+	{
+		Light[index] = (Light[index] & 0x0F) | (FMath::Min<uint8>(Level, 15) << 4);
+	}
+}
+
+void TChunkData::SetBlockLight(const FIntVector& Position, const uint8 Level)
+{
+	if(const int32 index = GetBlockIndex(Position); index >= 0 && index < Light.Num())
+	{
+		Light[index] = (Light[index] & 0xF0) | FMath::Min<uint8>(Level, 15);
+	}
+}
+
+uint8 TChunkData::GetFluidLevel(const FIntVector& Position) const
+{
+	const int32 index = GetBlockIndex(Position);
+	return index >= 0 && index < FluidLevels.Num() ? FluidLevels[index] : 0;
+}
+
+void TChunkData::SetFluidLevel(const FIntVector& Position, const uint8 Level)
+{
+	if(const int32 index = GetBlockIndex(Position); index >= 0 && index < FluidLevels.Num())
+	{
+		FluidLevels[index] = Level;
+	}
+}
@@ -2,11 +2,7 @@
 
 
 #include "World/ChunkStorage.h"
-
-#include <string>
-
-#include "Serialization/BufferArchive.h"
-#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "VoxelCore/ChunkCodec.h"
 
 UChunkStorage::UChunkStorage()
 {
@@ -15,69 +11,45 @@ UChunkStorage::UChunkStorage()
 
 bool UChunkStorage::SaveChunk(const FIntVector& InPosition, const TChunkData& InBlocks) const
 {
-	FBufferArchive archive = FBufferArchive();
-	FIntVector pos = InBlocks.GetChunkSize();
-	archive << pos;
-
-	FBlock BlockTmp = Air;
-	uint32 blocks = 0;
-	for(auto block : InBlocks)
-	{
-		if(blocks != 0 && BlockTmp != block)
-		{
-			archive << blocks;
-			archive << BlockTmp;
-			blocks = 0;
-		}
-		if(blocks == 0)
-		{
-			BlockTmp = block;
-		}
-		blocks++;
-	}
-	if(blocks != 0)
+	const FIntVector& ChunkSize = InBlocks.GetChunkSize();
+	VoxelCore::FChunkEncoder encoder(ChunkSize.X, ChunkSize.Y, ChunkSize.Z);
+	for(const FBlock& block : InBlocks)
 	{
-		archive << blocks;
-		archive << BlockTmp;
+		encoder.Add({block.BlockTypeID, block.bIsVisible});
 	}
+	const std::vector<uint8_t> data = encoder.Finish();
+
 	const FString name = FString::Format(TEXT("{0}{1}{2}.chunk"), {InPosition.X < 0 ? abs(InPosition.X)*2-1 : InPosition.X*2, InPosition.Y < 0 ? abs(InPosition.Y)*2-1 : InPosition.Y*2,InPosition.Z < 0 ? abs(InPosition.Z)*2-1 : InPosition.Z*2});
 	const FString FilePath = StoragePath + "Map/" + name;
-	FFileHelper::SaveArrayToFile(archive, *FilePath);
-	archive.FlushCache();
-	archive.Empty();
-	return true;
+	return FFileHelper::SaveArrayToFile(TArrayView<const uint8>(data.data(), static_cast<int32>(data.size())), *FilePath);
 }
 
 TOptional<TChunkData> UChunkStorage::LoadChunk(const FIntVector& InPosition) const
 {
 	FString name = FString::Format(TEXT("{0}{1}{2}.chunk"), {InPosition.X < 0 ? abs(InPosition.X)*2-1 : InPosition.X*2, InPosition.Y < 0 ? abs(InPosition.Y)*2-1 : InPosition.Y*2,InPosition.Z < 0 ? abs(InPosition.Z)*2-1 : InPosition.Z*2});
 	FString FilePath = StoragePath + "Map/" + name;
-	FBufferArchive BinaryArray = FBufferArchive();
-	TArray<FBlock> Blocks;
+	TArray<uint8> BinaryArray;
 	if(!FFileHelper::LoadFileToArray(BinaryArray, *FilePath, FILEREAD_Silent)) return {};
 	if(BinaryArray.Num() <= 0) return {};
-	FMemoryReader FromBinary(BinaryArray, true);
-	FromBinary.Seek(0);
-	FIntVector ChunkSize(-1);
-	while (!FromBinary.AtEnd())
+
+	int32_t ChunkSize[3];
+	std::vector<VoxelCore::FBlockRun> runs;
+	if(!VoxelCore::DecodeChunk(BinaryArray.GetData(), BinaryArray.Num(), ChunkSize, runs)) return {};
+
+	// The decoder checked the runs add up to the chunk size, this only keeps a broken file from growing the array past it
+	const int32 BlockCount = ChunkSize[0] * ChunkSize[1] * ChunkSize[2];
+	TArray<FBlock> Blocks;
+	Blocks.Reserve(BlockCount);
+	for (const VoxelCore::FBlockRun& run : runs)
 	{
-		if(ChunkSize == FIntVector(-1))
-		{
-			FromBinary << ChunkSize;
-		}
-		else
+		if(run.Count > static_cast<uint32>(BlockCount - Blocks.Num())) return {};
+		FBlock block(run.Block.BlockTypeId);
+		block.bIsVisible = run.Block.bIsVisible;
+		const int32 start = Blocks.AddUninitialized(static_cast<int32>(run.Count));
+		for (int32 index = start; index < Blocks.Num(); ++index)
 		{
-			uint32 count;
-			FBlock loadedBlock;
-			FromBinary << count;
-			FromBinary << loadedBlock;
-			for (uint32 i = 0; i < count; ++i)
-			{
-				Blocks.Add(loadedBlock);
-			}
+			Blocks[index] = block;
 		}
 	}
-	FObjectAndNameAsStringProxyArchive Ar(FromBinary, true);
-	BinaryArray.Empty();
-	return TChunkData(ChunkSize, Blocks);
+	return TChunkData(FIntVector(ChunkSize[0], ChunkSize[1], ChunkSize[2]), Blocks);
 }
@@ -0,0 +1,174 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/DensityGenerator.h"
+#include "Globals.h"
+
+DECLARE_CYCLE_STAT(TEXT("Generate density chunk"), STAT_DensityGenerator, STATGROUP_CubicWorld);
+
+UDensityGenerator::UDensityGenerator()
+{
+	// Finer than the height noise and not correlated with it
+	DensityNoiseConfig.Seed = 1338;
+	DensityNoiseConfig.Frequency = 0.02f;
+	DensityNoiseConfig.Octaves = 2;
+}
+
+void UDensityGenerator::Init()
+{
+	HeightNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+	HeightNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
+	HeightNoise.SetSeed(HeightNoiseConfig.Seed);
+	HeightNoise.SetFrequency(HeightNoiseConfig.Frequency);
+	HeightNoise.SetFractalGain(HeightNoiseConfig.Gain);
+	HeightNoise.SetFractalOctaves(HeightNoiseConfig.Octaves);
+	HeightNoise.SetFractalLacunarity(HeightNoiseConfig.Lacunarity);
+
+	DensityNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+	DensityNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
+	DensityNoise.SetSeed(DensityNoiseConfig.Seed);
+	DensityNoise.SetFrequency(DensityNoiseConfig.Frequency);
+	DensityNoise.SetFractalGain(DensityNoiseConfig.Gain);
+	DensityNoise.SetFractalOctaves(DensityNoiseConfig.Octaves);
+	DensityNoise.SetFractalLacunarity(DensityNoiseConfig.Lacunarity);
+
+	bHasBeenInitialized = true;
+	auto SortPredicate = [&](const FBlockLayer& A, const FBlockLayer& B)->bool
+	{
+		return A.Height < B.Height;
+	};
+	Layers.Sort(SortPredicate);
+}
+
+TOptional<FBlock> UDensityGenerator::GetLayerBlock(const int32 WorldZ, const float MaxHeight, const bool bIsTop) const
+{
+	const float blockHeightPercentage = WorldZ / MaxHeight;
+	for (const FBlockLayer& layer : Layers)
+	{
+		if(blockHeightPercentage < layer.Height)
+		{
+			return TOptional(FBlock(layer.bTopBlockDiffers && bIsTop ? layer.TopBlockTypeId : layer.BlockTypeId));
+		}
+	}
+	return TOptional<FBlock>();
+}
+
+void UDensityGenerator::GenerateChunk(const FChunkConfig& ChunkConfig, TChunkData& Blocks)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DensityGenerator);
+	if(!bHasBeenInitialized) Init();
+
+	const FIntVector& ChunkSize = ChunkConfig.WorldConfig.ChunkSize;
+	const FIntVector ChunkOrigin = ChunkConfig.GetChunkPositionInBlocks();
+	const float MaxHeight = ChunkConfig.WorldConfig.GetWorldBlockHeight();
+	const int32 Spacing = FMath::Max(1, SampleSpacing);
+	// Samples sit on a world lattice, so chunks share the samples on their borders whatever the spacing
+	const FIntVector LatticeOrigin(
+		FloorDivide(ChunkOrigin.X, Spacing) * Spacing,
+		FloorDivide(ChunkOrigin.Y, Spacing) * Spacing,
+		FloorDivide(ChunkOrigin.Z, Spacing) * Spacing);
+	const FIntVector Offset = ChunkOrigin - LatticeOrigin;
+	// The last sample in Z reaches the block above the chunk, it decides the top blocks
+	const FIntVector SampleCount(
+		FMath::DivideAndRoundUp(Offset.X + ChunkSize.X - 1, Spacing) + 1,
+		FMath::DivideAndRoundUp(Offset.Y + ChunkSize.Y - 1, Spacing) + 1,
+		FMath::DivideAndRoundUp(Offset.Z + ChunkSize.Z, Spacing) + 1);
+
+	TArray<float> Heights;
+	Heights.SetNumUninitialized(SampleCount.X * SampleCount.Y);
+	HeightNoise.GetNoiseGrid2D(Heights.GetData(), LatticeOrigin.X, LatticeOrigin.Y, SampleCount.X, SampleCount.Y, Spacing);
+	float minHeight = MAX_flt;
+	float maxHeight = -MAX_flt;
+	for (float& height : Heights)
+	{
+		height = FMath::Pow(height / 2.0f + 0.5f, HeightNoiseConfig.Power) * MaxHeight;
+		minHeight = FMath::Min(minHeight, height);
+		maxHeight = FMath::Max(maxHeight, height);
+	}
+
+	// The density noise stays within -1 and 1, so it can't reach further than the falloff from the surface.
+	// Interpolated heights stay between the samples
+	const int32 ChunkTop = ChunkOrigin.Z + ChunkSize.Z - 1;
+	if(ChunkOrigin.Z >= maxHeight + DensityFalloff)
+	{
+		return;
+	}
+	if(ChunkTop + 1 <= minHeight - DensityFalloff)
+	{
+		for (int32 Z = 0; Z < ChunkSize.Z; ++Z)
+		{
+			const TOptional<FBlock> block = GetLayerBlock(ChunkOrigin.Z + Z, MaxHeight, false);
+			if(!block.IsSet()) continue;
+			for (int32 Y = 0; Y < ChunkSize.Y; ++Y)
+			{
+				for (int32 X = 0; X < ChunkSize.X; ++X)
+				{
+					if(Blocks.GetBlock(FIntVector(X, Y, Z)) == Air) Blocks.SetBlock(FIntVector(X, Y, Z), block.GetValue());
+				}
+			}
+		}
+		return;
+	}
+
+	TArray<float> Densities;
+	Densities.SetNumUninitialized(SampleCount.X * SampleCount.Y * SampleCount.Z);
+	DensityNoise.GetNoiseGrid3D(Densities.GetData(), LatticeOrigin.X, LatticeOrigin.Y, LatticeOrigin.Z, SampleCount.X, SampleCount.Y, SampleCount.Z, Spacing);
+	for (int32 Z = 0; Z < SampleCount.Z; ++Z)
+	{
+		const int32 WorldZ = LatticeOrigin.Z + Z * Spacing;
+		for (int32 Index = 0; Index < Heights.Num(); ++Index)
+		{
+			Densities[Z * Heights.Num() + Index] += (Heights[Index] - WorldZ) / DensityFalloff;
+		}
+	}
+
+	auto GetSample = [&](const int32 X, const int32 Y, const int32 Z)
+	{
+		return Densities[(Z * SampleCount.Y + Y) * SampleCount.X + X];
+	};
+
+	TArray<float> ColumnSamples;
+	ColumnSamples.SetNumUninitialized(SampleCount.Z);
+	TArray<float> Column;
+	Column.SetNumUninitialized(ChunkSize.Z + 1);
+	for (int32 X = 0; X < ChunkSize.X; ++X)
+	{
+		const int32 LatticeX = Offset.X + X;
+		const int32 X0 = LatticeX / Spacing;
+		const int32 X1 = FMath::Min(X0 + 1, SampleCount.X - 1);
+		const float AlphaX = static_cast<float>(LatticeX % Spacing) / Spacing;
+		for (int32 Y = 0; Y < ChunkSize.Y; ++Y)
+		{
+			const int32 LatticeY = Offset.Y + Y;
+			const int32 Y0 = LatticeY / Spacing;
+			const int32 Y1 = FMath::Min(Y0 + 1, SampleCount.Y - 1);
+			const float AlphaY = static_cast<float>(LatticeY % Spacing) / Spacing;
+
+			// Bilinear at every sample height, then linear along the column
+			for (int32 Z = 0; Z < SampleCount.Z; ++Z)
+			{
+				ColumnSamples[Z] = FMath::Lerp(
+					FMath::Lerp(GetSample(X0, Y0, Z), GetSample(X1, Y0, Z), AlphaX),
+					FMath::Lerp(GetSample(X0, Y1, Z), GetSample(X1, Y1, Z), AlphaX),
+					AlphaY);
+			}
+			for (int32 Z = 0; Z <= ChunkSize.Z; ++Z)
+			{
+				const int32 LatticeZ = Offset.Z + Z;
+				const int32 Z0 = LatticeZ / Spacing;
+				const int32 Z1 = FMath::Min(Z0 + 1, SampleCount.Z - 1);
+				Column[Z] = FMath::Lerp(ColumnSamples[Z0], ColumnSamples[Z1], static_cast<float>(LatticeZ % Spacing) / Spacing);
+			}
+
+			for (int32 Z = 0; Z < ChunkSize.Z; ++Z)
+			{
+				const FIntVector Position(X, Y, Z);
+				if(Column[Z] <= 0 || Blocks.GetBlock(Position) != Air) continue;
+				if(TOptional<FBlock> block = GetLayerBlock(ChunkOrigin.Z + Z, MaxHeight, Column[Z + 1] <= 0); block.IsSet())
+				{
+					Blocks.SetBlock(Position, block.GetValue());
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,284 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/FluidSimulation.h"
+#include "Globals.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Fluid step"), STAT_FluidStep, STATGROUP_CubicWorld);
+DECLARE_CYCLE_STAT(TEXT("Activate fluid chunk"), STAT_ActivateFluidChunk, STATGROUP_CubicWorld);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active fluid cells"), STAT_ActiveFluidCells, STATGROUP_CubicWorld);
+
+namespace
+{
+	// Top, Bottom, Front, Back, Right, Left
+	const FIntVector Directions[6] = {{0,0,1}, {0,0,-1}, {0,1,0}, {0,-1,0}, {1,0,0}, {-1,0,0}};
+	const FIntVector Horizontal[4] = {{0,1,0}, {1,0,0}, {0,-1,0}, {-1,0,0}};
+}
+
+FFluidSimulation::FFluidSimulation(TMap<FIntVector, UChunk*>* InChunks, const FWorldConfig& InWorldConfig) :
+	Chunks(InChunks),
+	WorldConfig(InWorldConfig)
+{
+}
+
+void FFluidSimulation::Activate(const FIntVector& InBlockPosition)
+{
+	ActiveCells.Add(InBlockPosition);
+	for (const FIntVector& Direction : Directions)
+	{
+		ActiveCells.Add(InBlockPosition + Direction);
+	}
+}
+
+void FFluidSimulation::ActivateChunk(const FIntVector& InChunkPosition)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ActivateFluidChunk);
+	const auto chunk = Chunks->Find(InChunkPosition);
+	if(chunk == nullptr || *chunk == nullptr || !(*chunk)->bIsReady) return;
+
+	const FIntVector ChunkSize = WorldConfig.ChunkSize;
+	const FIntVector Origin(InChunkPosition.X * ChunkSize.X, InChunkPosition.Y * ChunkSize.Y, InChunkPosition.Z * ChunkSize.Z);
+	const TChunkData& Blocks = (*chunk)->GetBlocks();
+
+	// Only fluid that can go somewhere needs a step, resting oceans stay inactive
+	for (int Z = 0; Z < ChunkSize.Z; ++Z)
+	{
+		for (int Y = 0; Y < ChunkSize.Y; ++Y)
+		{
+			for (int X = 0; X < ChunkSize.X; ++X)
+			{
+				const FIntVector Local(X, Y, Z);
+				const bool bIsBorder = X == 0 || Y == 0 || Z == 0 || X == ChunkSize.X-1 || Y == ChunkSize.Y-1 || Z == ChunkSize.Z-1;
+				const FBlock Block = Blocks.GetBlock(Local);
+				if(!IsFluid(Block) && !bIsBorder) continue;
+
+				for (const FIntVector& Direction : Directions)
+				{
+					const FIntVector Neighbor = Origin + Local + Direction;
+					if(IsFluid(Block))
+					{
+						const FFluidCell Cell = GetCell(Neighbor);
+						if(Cell.bCanHoldFluid && Cell.Block != Block)
+						{
+							ActiveCells.Add(Origin + Local);
+							break;
+						}
+					}
+					else if(Block == Air && IsFluid(GetCell(Neighbor).Block))
+					{
+						// Fluid of a neighbor chunk that was held back by the unloaded chunk
+						ActiveCells.Add(Neighbor);
+					}
+				}
+			}
+		}
+	}
+}
+
+void FFluidSimulation::UpdateBlock(const FIntVector& InBlockPosition, const FBlock& InOldBlock, const FBlock& InNewBlock)
+{
+	if(IsFluid(InOldBlock) && !IsFluid(InNewBlock))
+	{
+		// Placed fluid starts full again
+		SetLevel(InBlockPosition, 0);
+	}
+	Activate(InBlockPosition);
+}
+
+void FFluidSimulation::SetLevel(const FIntVector& InBlockPosition, const uint8 InLevel)
+{
+	FIntVector LocalPosition;
+	if(UChunk* chunk = FindChunk(InBlockPosition, LocalPosition))
+	{
+		chunk->GetMutableBlocks().SetFluidLevel(LocalPosition, InLevel >= MaxLevel ? 0 : InLevel);
+	}
+}
+
+uint8 FFluidSimulation::GetLevel(const FIntVector& InBlockPosition) const
+{
+	return GetCell(InBlockPosition).Level;
+}
+
+bool FFluidSimulation::IsFluid(const FBlock& InBlock) const
+{
+	return InBlock != Air && WorldConfig.BlockTypes.IsValidIndex(InBlock.BlockTypeID) && WorldConfig.BlockTypes[InBlock.BlockTypeID].bIsFluid;
+}
+
+void FFluidSimulation::Tick(const float InDeltaTime, TArray<TPair<FIntVector, FBlock>>& OutBlockChanges)
+{
+	// At most one step per call, the next step has to see the block changes of this one
+	const float StepTime = 1.0f / FMath::Max(WorldConfig.FluidTickRate, 1.0f);
+	Accumulator = FMath::Min(Accumulator + InDeltaTime, StepTime * 2);
+	if(Accumulator < StepTime) return;
+
+	Accumulator -= StepTime;
+	if(!ActiveCells.IsEmpty())
+	{
+		Step(OutBlockChanges);
+	}
+	StepCount++;
+	SET_DWORD_STAT(STAT_ActiveFluidCells, ActiveCells.Num());
+}
+
+UChunk* FFluidSimulation::FindChunk(const FIntVector& InBlockPosition, FIntVector& OutLocalPosition) const
+{
+	const FIntVector ChunkSize = WorldConfig.ChunkSize;
+	const FIntVector ChunkPosition(FloorDivide(InBlockPosition.X, ChunkSize.X), FloorDivide(InBlockPosition.Y, ChunkSize.Y), FloorDivide(InBlockPosition.Z, ChunkSize.Z));
+	OutLocalPosition = FIntVector(InBlockPosition.X - ChunkPosition.X * ChunkSize.X,
+								  InBlockPosition.Y - ChunkPosition.Y * ChunkSize.Y,
+								  InBlockPosition.Z - ChunkPosition.Z * ChunkSize.Z);
+	const auto chunk = Chunks->Find(ChunkPosition);
+	return chunk != nullptr && *chunk != nullptr && (*chunk)->bIsReady ? *chunk : nullptr;
+}
+
+FFluidSimulation::FFluidCell FFluidSimulation::GetCell(const FIntVector& InBlockPosition) const
+{
+	FFluidCell Cell;
+	FIntVector LocalPosition;
+	const UChunk* chunk = FindChunk(InBlockPosition, LocalPosition);
+	// Unloaded chunks and the world bottom act as walls
+	if(chunk == nullptr || InBlockPosition.Z < 0) return Cell;
+
+	Cell.bIsLoaded = true;
+	Cell.Block = chunk->GetBlocks().GetBlock(LocalPosition);
+	if(IsFluid(Cell.Block))
+	{
+		const uint8 Level = chunk->GetBlocks().GetFluidLevel(LocalPosition);
+		Cell.Level = Level == 0 ? MaxLevel : FMath::Min(Level, MaxLevel);
+		Cell.bCanHoldFluid = true;
+	} else
+	{
+		Cell.bCanHoldFluid = Cell.Block == Air;
+	}
+	return Cell;
+}
+
+void FFluidSimulation::ComputeFlow(const FIntVector& InBlockPosition, FFluidFlow& OutFlow) const
+{
+	OutFlow.Source = InBlockPosition;
+	const FFluidCell Cell = GetCell(InBlockPosition);
+	if(!IsFluid(Cell.Block)) return;
+
+	OutFlow.Fluid = Cell.Block;
+	if(StepCount % FMath::Max<uint8>(WorldConfig.BlockTypes[Cell.Block.BlockTypeID].FluidTickInterval, 1) != 0)
+	{
+		OutFlow.bKeepActive = true;
+		return;
+	}
+
+	const auto CanReceive = [&Cell](const FFluidCell& InTarget)
+	{
+		return InTarget.bCanHoldFluid && (InTarget.Block == Air || InTarget.Block == Cell.Block);
+	};
+
+	int32 Remaining = Cell.Level;
+	const FFluidCell Below = GetCell(InBlockPosition - FIntVector(0, 0, 1));
+	if(CanReceive(Below) && Below.Level < MaxLevel)
+	{
+		const int32 Amount = FMath::Min<int32>(Remaining, MaxLevel - Below.Level);
+		OutFlow.Targets[OutFlow.Count] = InBlockPosition - FIntVector(0, 0, 1);
+		OutFlow.Amounts[OutFlow.Count++] = Amount;
+		Remaining -= Amount;
+	}
+
+	// Spread one unit to each lower neighbor, the start direction rotates so no side is preferred
+	for (int32 Index = 0; Index < 4 && Remaining > 1; ++Index)
+	{
+		const FIntVector Target = InBlockPosition + Horizontal[(Index + StepCount) % 4];
+		const FFluidCell Neighbor = GetCell(Target);
+		if(CanReceive(Neighbor) && Neighbor.Level + 1 < Remaining)
+		{
+			OutFlow.Targets[OutFlow.Count] = Target;
+			OutFlow.Amounts[OutFlow.Count++] = 1;
+			Remaining--;
+		}
+	}
+}
+
+void FFluidSimulation::Step(TArray<TPair<FIntVector, FBlock>>& OutBlockChanges)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FluidStep);
+
+	// Sorted so the result does not depend on the set order, bottom cells go first
+	TArray<FIntVector> Cells = ActiveCells.Array();
+	Cells.Sort([](const FIntVector& A, const FIntVector& B)
+	{
+		if(A.Z != B.Z) return A.Z < B.Z;
+		if(A.Y != B.Y) return A.Y < B.Y;
+		return A.X < B.X;
+	});
+	ActiveCells.Reset();
+	if(WorldConfig.MaxFluidCellsPerStep > 0 && Cells.Num() > WorldConfig.MaxFluidCellsPerStep)
+	{
+		for (int32 Index = WorldConfig.MaxFluidCellsPerStep; Index < Cells.Num(); ++Index)
+		{
+			ActiveCells.Add(Cells[Index]);
+		}
+		Cells.SetNum(WorldConfig.MaxFluidCellsPerStep);
+	}
+
+	// Every cell only reads the world here, so the flows can be computed in parallel
+	TArray<FFluidFlow> Flows;
+	Flows.SetNum(Cells.Num());
+	ParallelFor(Cells.Num(), [&](const int32 Index)
+	{
+		ComputeFlow(Cells[Index], Flows[Index]);
+	});
+
+	struct FPendingCell
+	{
+		FBlock Fluid;
+		int32 Level = 0;
+	};
+	TMap<FIntVector, FPendingCell> Pending;
+	const auto Touch = [this, &Pending](const FIntVector& InPosition)
+	{
+		if(!Pending.Contains(InPosition))
+		{
+			const FFluidCell Cell = GetCell(InPosition);
+			Pending.Add(InPosition, {IsFluid(Cell.Block) ? Cell.Block : Air, Cell.Level});
+		}
+	};
+
+	// Applied in cell order, a target takes what fits and never mixes two fluids
+	for (const FFluidFlow& Flow : Flows)
+	{
+		if(Flow.bKeepActive)
+		{
+			ActiveCells.Add(Flow.Source);
+			continue;
+		}
+		if(Flow.Count == 0) continue;
+
+		Touch(Flow.Source);
+		for (int32 Index = 0; Index < Flow.Count; ++Index)
+		{
+			Touch(Flow.Targets[Index]);
+			FPendingCell& Source = Pending[Flow.Source];
+			FPendingCell& Target = Pending[Flow.Targets[Index]];
+			if(Target.Fluid != Air && Target.Fluid != Flow.Fluid) continue;
+
+			const int32 Amount = FMath::Min3<int32>(Flow.Amounts[Index], MaxLevel - Target.Level, Source.Level);
+			if(Amount <= 0) continue;
+
+			Source.Level -= Amount;
+			Target.Level += Amount;
+			Target.Fluid = Flow.Fluid;
+		}
+	}
+
+	for (const auto& pending : Pending)
+	{
+		const FFluidCell Cell = GetCell(pending.Key);
+		const FBlock NewBlock = pending.Value.Level > 0 ? pending.Value.Fluid : Air;
+		if(NewBlock == Cell.Block && pending.Value.Level == Cell.Level) continue;
+
+		SetLevel(pending.Key, pending.Value.Level);
+		if(NewBlock != Cell.Block)
+		{
+			OutBlockChanges.Emplace(pending.Key, NewBlock);
+		}
+		Activate(pending.Key);
+	}
+}
@@ -2,10 +2,36 @@
 
 
 #include "World/Generator.h"
+#include "Globals.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Air chunks skipped"), STAT_AirChunksSkipped, STATGROUP_CubicWorld);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Solid chunks filled"), STAT_SolidChunksFilled, STATGROUP_CubicWorld);
 
 void UGenerator::GenerateChunk(const FChunkConfig& ChunkConfig, TChunkData& Blocks)
 {
+	const FIntVector ChunkOrigin = ChunkConfig.GetChunkPositionInBlocks();
+	const int32 ChunkTop = ChunkOrigin.Z + ChunkConfig.WorldConfig.ChunkSize.Z - 1;
+	if(int32 minHeight, maxHeight; GetHeightRange(ChunkConfig, minHeight, maxHeight))
+	{
+		if(ChunkOrigin.Z > maxHeight)
+		{
+			INC_DWORD_STAT(STAT_AirChunksSkipped);
+			return;
+		}
+		if(ChunkTop < minHeight)
+		{
+			if(const TOptional<FBlock> fill = GetSolidFill(ChunkConfig, ChunkOrigin.Z, ChunkTop); fill.IsSet())
+			{
+				INC_DWORD_STAT(STAT_SolidChunksFilled);
+				for (FBlock& block : Blocks)
+				{
+					if(block == Air) block = fill.GetValue();
+				}
+				return;
+			}
+		}
+	}
+
 	for (int X = 0; X < ChunkConfig.WorldConfig.ChunkSize.X; ++X)
 	{
 		for (int Y = 0; Y < ChunkConfig.WorldConfig.ChunkSize.Y; ++Y)
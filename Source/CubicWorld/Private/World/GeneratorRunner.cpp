@@ -3,9 +3,17 @@
 
 #include "World/GeneratorRunner.h"
 #include "Globals.h"
+#include "Async/ParallelFor.h"
 
 
 DECLARE_CYCLE_STAT(TEXT("generate chunks in generator runner"), STAT_Generator, STATGROUP_CubicWorld);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Generator pipeline chunks"), STAT_PipelineChunks, STATGROUP_CubicWorld);
+
+namespace
+{
+	// Steps run in parallel before new tasks and cancellations are picked up
+	constexpr int32 MaxStepsPerBatch = 64;
+}
 
 #pragma region Main Thread Code
 
@@ -24,6 +32,21 @@ FGeneratorRunner::~FGeneratorRunner()
 	}
 }
 
+void FGeneratorRunner::AddTask(const FIntVector& InChunkPosition, const TChunkData& InBlocks)
+{
+	{
+		FScopeLock Lock(&CancelledSyncRoot);
+		Cancelled.Remove(InChunkPosition);
+	}
+	Tasks.Enqueue({InChunkPosition, InBlocks});
+}
+
+void FGeneratorRunner::CancelTask(const FIntVector& InChunkPosition)
+{
+	FScopeLock Lock(&CancelledSyncRoot);
+	Cancelled.Add(InChunkPosition);
+}
+
 #pragma endregion
 
 bool FGeneratorRunner::Init()
@@ -36,21 +59,50 @@ uint32 FGeneratorRunner::Run()
 {
 	LLM_SCOPE(ELLMTag::Landscape);
 	if(Generator == nullptr) return -1;
+	Generator->Init();
+	for (UGeneratorStage* stage : Generator->Stages)
+	{
+		if(stage == nullptr) continue;
+		stage->Init();
+		Stages.Add(stage);
+	}
+
 	while (bShouldRun)
 	{
-		if(!Tasks.IsEmpty())
+		TPair<FIntVector, TChunkData> task;
+		while (Tasks.Dequeue(task))
+		{
+			if(!Pipeline.Contains(task.Key))
+			{
+				Pipeline.Add(task.Key).Blocks = MoveTemp(task.Value);
+			}
+			Require(task.Key, GetStepCount());
+			Pipeline[task.Key].bRequested = true;
+			if(Pipeline[task.Key].Done == GetStepCount())
+			{
+				FinishStep(task.Key);
+			}
+		}
+
+		// After the tasks, a cancel that comes before a new task for the same chunk is already cleared by AddTask
+		TSet<FIntVector> cancelled;
 		{
-			SCOPE_CYCLE_COUNTER(STAT_Generator);
-			SCOPED_NAMED_EVENT(FGeneratorRunner_Generate, FColor::Red);
-			TPair<FIntVector, TChunkData> task;
-			Tasks.Dequeue(task);
-			FChunkConfig chunkConfig = FChunkConfig(WorldConfig, task.Key);
-			TChunkData blocks = task.Value;
-			Generator->GenerateChunk(chunkConfig, blocks);
-			TPair<FIntVector, TChunkData> result;
-			result.Key = task.Key;
-			result.Value = blocks;
-			Results.Enqueue(result);
+			FScopeLock Lock(&CancelledSyncRoot);
+			cancelled = MoveTemp(Cancelled);
+			Cancelled.Reset();
+		}
+		for (const FIntVector& position : cancelled)
+		{
+			if(FPipelineChunk* chunk = Pipeline.Find(position))
+			{
+				chunk->bRequested = false;
+				DropIfUnused(position);
+			}
+		}
+
+		if(!RunReadySteps())
+		{
+			FPlatformProcess::Sleep(0.001f);
 		}
 	}
 	UE_LOG(LogTemp, Warning, TEXT("Generator runner stopped"))
@@ -58,6 +110,178 @@ uint32 FGeneratorRunner::Run()
 	return 0;
 }
 
+int32 FGeneratorRunner::GetStepCount() const
+{
+	return Stages.Num() + 1;
+}
+
+int32 FGeneratorRunner::GetDependencyRadius(const int32 InStep) const
+{
+	return InStep > 0 ? FMath::Max(Stages[InStep - 1]->DependencyRadius, 0) : 0;
+}
+
+void FGeneratorRunner::ForEachDependency(const FIntVector& InChunkPosition, const int32 InStep, TFunctionRef<void(const FIntVector&)> InFunction) const
+{
+	const int32 Radius = GetDependencyRadius(InStep);
+	const bool bWholeColumns = InStep > 0 && Stages[InStep - 1]->bDependsOnWholeColumns;
+	const int32 MinZ = bWholeColumns ? 0 : FMath::Max(InChunkPosition.Z - Radius, 0);
+	const int32 MaxZ = bWholeColumns ? WorldConfig.MaxChunksZ - 1 : FMath::Min(InChunkPosition.Z + Radius, WorldConfig.MaxChunksZ - 1);
+	for (int32 Z = MinZ; Z <= MaxZ; ++Z)
+	{
+		for (int32 Y = InChunkPosition.Y - Radius; Y <= InChunkPosition.Y + Radius; ++Y)
+		{
+			for (int32 X = InChunkPosition.X - Radius; X <= InChunkPosition.X + Radius; ++X)
+			{
+				if(const FIntVector position(X, Y, Z); position != InChunkPosition)
+				{
+					InFunction(position);
+				}
+			}
+		}
+	}
+}
+
+void FGeneratorRunner::Require(const FIntVector& InChunkPosition, const int32 InTarget)
+{
+	FPipelineChunk* chunk = Pipeline.Find(InChunkPosition);
+	if(chunk == nullptr)
+	{
+		chunk = &Pipeline.Add(InChunkPosition);
+		chunk->Blocks = TChunkData(WorldConfig.ChunkSize);
+	}
+	if(chunk->Target >= InTarget) return;
+	const int32 firstStep = FMath::Max(chunk->Target, 1);
+	chunk->Target = InTarget;
+
+	// Step n needs the chunks in its radius to have done the n steps before it
+	TArray<TPair<FIntVector, int32>> dependencies;
+	for (int32 step = firstStep; step < InTarget; ++step)
+	{
+		ForEachDependency(InChunkPosition, step, [&](const FIntVector& position)
+		{
+			dependencies.Add({position, step});
+		});
+	}
+	for (const TPair<FIntVector, int32>& dependency : dependencies)
+	{
+		Require(dependency.Key, dependency.Value);
+		bool bIsAlreadyRequired = false;
+		Pipeline[InChunkPosition].Required.Add(dependency.Key, &bIsAlreadyRequired);
+		if(!bIsAlreadyRequired)
+		{
+			Pipeline[dependency.Key].Users++;
+		}
+	}
+}
+
+void FGeneratorRunner::ReleaseRequired(const FIntVector& InChunkPosition)
+{
+	const TSet<FIntVector> required = MoveTemp(Pipeline[InChunkPosition].Required);
+	Pipeline[InChunkPosition].Required.Reset();
+	for (const FIntVector& position : required)
+	{
+		if(FPipelineChunk* chunk = Pipeline.Find(position))
+		{
+			chunk->Users--;
+			DropIfUnused(position);
+		}
+	}
+}
+
+void FGeneratorRunner::DropIfUnused(const FIntVector& InChunkPosition)
+{
+	if(const FPipelineChunk* chunk = Pipeline.Find(InChunkPosition); chunk == nullptr || chunk->bRequested || chunk->Users > 0)
+	{
+		return;
+	}
+	ReleaseRequired(InChunkPosition);
+	Pipeline.Remove(InChunkPosition);
+}
+
+void FGeneratorRunner::FinishStep(const FIntVector& InChunkPosition)
+{
+	FPipelineChunk& chunk = Pipeline[InChunkPosition];
+	if(chunk.Done < chunk.Target) return;
+	if(chunk.bRequested)
+	{
+		Results.Enqueue({InChunkPosition, chunk.Blocks});
+		chunk.bRequested = false;
+	}
+	ReleaseRequired(InChunkPosition);
+	DropIfUnused(InChunkPosition);
+}
+
+void FGeneratorRunner::RunStep(const FIntVector& InChunkPosition)
+{
+	FPipelineChunk& chunk = Pipeline.FindChecked(InChunkPosition);
+	const FChunkConfig chunkConfig(WorldConfig, InChunkPosition);
+	if(chunk.Done == 0)
+	{
+		Generator->GenerateChunk(chunkConfig, chunk.Blocks);
+		return;
+	}
+
+	UGeneratorStage* stage = Stages[chunk.Done - 1];
+	if(!stage->ShouldGenerate(chunkConfig)) return;
+	FScopeCycleCounterUObject StageScope(stage);
+	FGeneratorStageNeighbors neighbors(WorldConfig.ChunkSize);
+	ForEachDependency(InChunkPosition, chunk.Done, [&](const FIntVector& position)
+	{
+		neighbors.Chunks.Add(position, &Pipeline.FindChecked(position).Blocks);
+	});
+	stage->Generate(chunkConfig, chunk.Blocks, neighbors);
+}
+
+bool FGeneratorRunner::RunReadySteps()
+{
+	SET_DWORD_STAT(STAT_PipelineChunks, Pipeline.Num());
+	// A chunk that is written can't be read or written by another step of the same batch
+	TArray<FIntVector> batch;
+	TSet<FIntVector> written;
+	TSet<FIntVector> read;
+	for (const TPair<FIntVector, FPipelineChunk>& entry : Pipeline)
+	{
+		const FPipelineChunk& chunk = entry.Value;
+		if(chunk.Done >= chunk.Target || written.Contains(entry.Key) || read.Contains(entry.Key)) continue;
+
+		bool bIsReady = true;
+		TArray<FIntVector> dependencies;
+		ForEachDependency(entry.Key, chunk.Done, [&](const FIntVector& position)
+		{
+			const FPipelineChunk* dependency = Pipeline.Find(position);
+			bIsReady &= dependency != nullptr && dependency->Done >= chunk.Done && !written.Contains(position);
+			dependencies.Add(position);
+		});
+		if(!bIsReady) continue;
+
+		batch.Add(entry.Key);
+		written.Add(entry.Key);
+		read.Append(dependencies);
+		if(batch.Num() >= MaxStepsPerBatch) break;
+	}
+	if(batch.IsEmpty()) return false;
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_Generator);
+		SCOPED_NAMED_EVENT(FGeneratorRunner_Generate, FColor::Red);
+		ParallelFor(batch.Num(), [&](const int32 Index)
+		{
+			RunStep(batch[Index]);
+		});
+	}
+
+	for (const FIntVector& position : batch)
+	{
+		// Finishing an earlier chunk of the batch can drop a dependency nothing waits for anymore
+		if(FPipelineChunk* chunk = Pipeline.Find(position))
+		{
+			chunk->Done++;
+			FinishStep(position);
+		}
+	}
+	return true;
+}
+
 void FGeneratorRunner::Stop()
 {
 	Tasks.Empty();
@@ -0,0 +1,21 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/GeneratorStage.h"
+#include "Globals.h"
+
+const TChunkData* FGeneratorStageNeighbors::GetChunk(const FIntVector& InChunkPosition) const
+{
+	const TChunkData* const* chunk = Chunks.Find(InChunkPosition);
+	return chunk != nullptr ? *chunk : nullptr;
+}
+
+FBlock FGeneratorStageNeighbors::GetBlock(const FIntVector& InWorldBlockPosition) const
+{
+	const FIntVector ChunkPosition(FloorDivide(InWorldBlockPosition.X, ChunkSize.X), FloorDivide(InWorldBlockPosition.Y, ChunkSize.Y), FloorDivide(InWorldBlockPosition.Z, ChunkSize.Z));
+	if(const TChunkData* chunk = GetChunk(ChunkPosition))
+	{
+		return chunk->GetBlock(InWorldBlockPosition - FIntVector(ChunkPosition.X * ChunkSize.X, ChunkPosition.Y * ChunkSize.Y, ChunkPosition.Z * ChunkSize.Z));
+	}
+	return Air;
+}
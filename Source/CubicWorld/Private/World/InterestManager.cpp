@@ -0,0 +1,223 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/InterestManager.h"
+#include "Globals.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update interest"), STAT_UpdateInterest, STATGROUP_CubicWorld);
+DECLARE_CYCLE_STAT(TEXT("Schedule chunk loads"), STAT_ScheduleChunkLoads, STATGROUP_CubicWorld);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interest columns"), STAT_InterestColumns, STATGROUP_CubicWorld);
+
+FInterestManager::FInterestManager(const FWorldConfig& InWorldConfig) :
+	WorldConfig(InWorldConfig)
+{
+}
+
+void FInterestManager::UpdateViewer(const UTrackable* InViewer, const FVector& InPosition, const int32 InDistance)
+{
+	SCOPE_CYCLE_COUNTER(STAT_UpdateInterest);
+	const TObjectKey<UTrackable> Key(InViewer);
+	FViewer* Viewer = Viewers.Find(Key);
+	if(Viewer == nullptr)
+	{
+		Viewer = &Viewers.Add(Key);
+		Viewer->Trackable = InViewer;
+		ViewerOrder.Add(Key);
+	}
+	Viewer->Position = InPosition;
+
+	const FIntPoint Center(FMath::RoundToInt(InPosition.X), FMath::RoundToInt(InPosition.Y));
+	// Keep is larger than Load so a trackable going back and forth over a chunk border doesn't reload it
+	const int32 Radii[3] = {InDistance + 1 + WorldConfig.UnloadMargin, InDistance + 1, InDistance};
+	for (const ETier Tier : {Keep, Load, Visible})
+	{
+		const FIntRect Window(Center - FIntPoint(Radii[Tier]), Center + FIntPoint(Radii[Tier] + 1));
+		if(Viewer->Windows[Tier] != Window)
+		{
+			MoveWindow(*Viewer, Tier, Window);
+		}
+	}
+	SET_DWORD_STAT(STAT_InterestColumns, Columns.Num());
+}
+
+void FInterestManager::SetPrefetchColumns(const UTrackable* InViewer, const TSet<FIntPoint>& InColumns)
+{
+	if(FViewer* Viewer = Viewers.Find(TObjectKey<UTrackable>(InViewer)))
+	{
+		SetPrefetchColumns(*Viewer, InColumns);
+	}
+}
+
+void FInterestManager::RemoveViewersExcept(const TSet<TObjectKey<UTrackable>>& InViewers)
+{
+	for (int32 Index = ViewerOrder.Num() - 1; Index >= 0; --Index)
+	{
+		if(!InViewers.Contains(ViewerOrder[Index]))
+		{
+			RemoveViewer(ViewerOrder[Index]);
+		}
+	}
+}
+
+bool FInterestManager::HasInterest(const FIntPoint& InColumn, const ETier InTier) const
+{
+	const FColumnInterest* Column = Columns.Find(InColumn);
+	return Column != nullptr && Column->Counts[InTier] > 0;
+}
+
+void FInterestManager::GetColumnsToLoad(const int32 InMaxColumns, TFunctionRef<bool(const FIntPoint&)> InIsRequested, TArray<FIntPoint>& OutColumns)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ScheduleChunkLoads);
+	if(ViewerOrder.IsEmpty()) return;
+
+	TArray<int32> Next;
+	Next.Reserve(ViewerOrder.Num());
+	for (const TObjectKey<UTrackable>& Key : ViewerOrder)
+	{
+		FViewer& Viewer = Viewers[Key];
+		// Columns loaded for someone else or left behind are dropped here
+		Viewer.LoadQueue.RemoveAll([this, &Viewer, &InIsRequested](const FIntPoint& InColumn)
+		{
+			return !WantsLoad(Viewer, InColumn) || InIsRequested(InColumn);
+		});
+
+		const UTrackable* Trackable = Viewer.Trackable.Get();
+		TArray<TPair<float, FIntPoint>> Priorities;
+		Priorities.Reserve(Viewer.LoadQueue.Num());
+		for (const FIntPoint& Column : Viewer.LoadQueue)
+		{
+			const FVector ColumnCenter(Column.X, Column.Y, Viewer.Position.Z);
+			Priorities.Emplace(Trackable != nullptr ? Trackable->GetChunkPriority(Viewer.Position, ColumnCenter) : FVector::Dist(Viewer.Position, ColumnCenter), Column);
+		}
+		Priorities.Sort([](const TPair<float, FIntPoint>& A, const TPair<float, FIntPoint>& B)
+		{
+			return A.Key > B.Key;
+		});
+		for (int32 Index = 0; Index < Priorities.Num(); ++Index)
+		{
+			Viewer.LoadQueue[Index] = Priorities[Index].Value;
+		}
+		Next.Add(Viewer.LoadQueue.Num() - 1);
+	}
+
+	TSet<FIntPoint> Taken;
+	bool bHasTaken = true;
+	while (bHasTaken && OutColumns.Num() < InMaxColumns)
+	{
+		bHasTaken = false;
+		for (int32 Offset = 0; Offset < ViewerOrder.Num() && OutColumns.Num() < InMaxColumns; ++Offset)
+		{
+			const int32 Index = (NextViewer + Offset) % ViewerOrder.Num();
+			const TArray<FIntPoint>& LoadQueue = Viewers[ViewerOrder[Index]].LoadQueue;
+			while (Next[Index] >= 0)
+			{
+				const FIntPoint Column = LoadQueue[Next[Index]--];
+				bool bIsAlreadyTaken = false;
+				Taken.Add(Column, &bIsAlreadyTaken);
+				if(!bIsAlreadyTaken)
+				{
+					OutColumns.Add(Column);
+					bHasTaken = true;
+					break;
+				}
+			}
+		}
+	}
+	NextViewer = (NextViewer + 1) % ViewerOrder.Num();
+}
+
+void FInterestManager::ConsumeChanges(TSet<FIntPoint>& OutKeepChanged, TSet<FIntPoint>& OutVisibleChanged)
+{
+	OutKeepChanged = MoveTemp(KeepChanged);
+	OutVisibleChanged = MoveTemp(VisibleChanged);
+	KeepChanged.Reset();
+	VisibleChanged.Reset();
+}
+
+void FInterestManager::AddInterest(const FIntPoint& InColumn, const ETier InTier, const int32 InDelta)
+{
+	FColumnInterest& Column = Columns.FindOrAdd(InColumn);
+	const bool bHadInterest = Column.Counts[InTier] > 0;
+	Column.Counts[InTier] += InDelta;
+	if(bHadInterest != (Column.Counts[InTier] > 0))
+	{
+		if(InTier == Keep) KeepChanged.Add(InColumn);
+		if(InTier == Visible) VisibleChanged.Add(InColumn);
+	}
+	if(Column.Counts[Keep] <= 0 && Column.Counts[Load] <= 0 && Column.Counts[Visible] <= 0)
+	{
+		Columns.Remove(InColumn);
+	}
+}
+
+void FInterestManager::SetPrefetchColumns(FViewer& InOutViewer, const TSet<FIntPoint>& InColumns)
+{
+	for (const FIntPoint& Column : InColumns)
+	{
+		if(!InOutViewer.Prefetch.Contains(Column))
+		{
+			AddInterest(Column, Keep, 1);
+			AddInterest(Column, Load, 1);
+			InOutViewer.LoadQueue.Add(Column);
+		}
+	}
+	for (const FIntPoint& Column : InOutViewer.Prefetch)
+	{
+		if(!InColumns.Contains(Column))
+		{
+			AddInterest(Column, Load, -1);
+			AddInterest(Column, Keep, -1);
+		}
+	}
+	InOutViewer.Prefetch = InColumns;
+}
+
+void FInterestManager::MoveWindow(FViewer& InOutViewer, const ETier InTier, const FIntRect& InWindow)
+{
+	const FIntRect OldWindow = InOutViewer.Windows[InTier];
+	for (int Y = OldWindow.Min.Y; Y < OldWindow.Max.Y; ++Y)
+	{
+		for (int X = OldWindow.Min.X; X < OldWindow.Max.X; ++X)
+		{
+			if(!InWindow.Contains(FIntPoint(X, Y)))
+			{
+				AddInterest(FIntPoint(X, Y), InTier, -1);
+			}
+		}
+	}
+	for (int Y = InWindow.Min.Y; Y < InWindow.Max.Y; ++Y)
+	{
+		for (int X = InWindow.Min.X; X < InWindow.Max.X; ++X)
+		{
+			if(!OldWindow.Contains(FIntPoint(X, Y)))
+			{
+				AddInterest(FIntPoint(X, Y), InTier, 1);
+				if(InTier == Load)
+				{
+					InOutViewer.LoadQueue.Add(FIntPoint(X, Y));
+				}
+			}
+		}
+	}
+	InOutViewer.Windows[InTier] = InWindow;
+}
+
+bool FInterestManager::WantsLoad(const FViewer& InViewer, const FIntPoint& InColumn) const
+{
+	return InViewer.Windows[Load].Contains(InColumn) || InViewer.Prefetch.Contains(InColumn);
+}
+
+void FInterestManager::RemoveViewer(const TObjectKey<UTrackable>& InViewer)
+{
+	FViewer* Viewer = Viewers.Find(InViewer);
+	if(Viewer == nullptr) return;
+
+	SetPrefetchColumns(*Viewer, TSet<FIntPoint>());
+	for (const ETier Tier : {Keep, Load, Visible})
+	{
+		MoveWindow(*Viewer, Tier, FIntRect());
+	}
+	Viewers.Remove(InViewer);
+	ViewerOrder.Remove(InViewer);
+	NextViewer = ViewerOrder.IsEmpty() ? 0 : NextViewer % ViewerOrder.Num();
+}
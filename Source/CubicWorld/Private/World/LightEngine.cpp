@@ -0,0 +1,250 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/LightEngine.h"
+#include "Globals.h"
+
+DECLARE_CYCLE_STAT(TEXT("Light chunk"), STAT_LightChunk, STATGROUP_CubicWorld);
+DECLARE_CYCLE_STAT(TEXT("Propagate light"), STAT_PropagateLight, STATGROUP_CubicWorld);
+
+namespace
+{
+	// Top, Bottom, Front, Back, Right, Left
+	const FIntVector Directions[6] = {{0,0,1}, {0,0,-1}, {0,1,0}, {0,-1,0}, {1,0,0}, {-1,0,0}};
+	constexpr int32 Down = 1;
+}
+
+FLightEngine::FLightEngine(TMap<FIntVector, UChunk*>* InChunks, const FWorldConfig& InWorldConfig) :
+	Chunks(InChunks),
+	WorldConfig(InWorldConfig)
+{
+}
+
+void FLightEngine::AddChunk(const FIntVector& InChunkPosition)
+{
+	SCOPE_CYCLE_COUNTER(STAT_LightChunk);
+	CachedChunk = nullptr;
+	const auto chunk = Chunks->Find(InChunkPosition);
+	if(chunk == nullptr || *chunk == nullptr || !(*chunk)->bIsReady) return;
+
+	const FIntVector ChunkSize = WorldConfig.ChunkSize;
+	const FIntVector Origin(InChunkPosition.X * ChunkSize.X, InChunkPosition.Y * ChunkSize.Y, InChunkPosition.Z * ChunkSize.Z);
+	const TChunkData& Blocks = (*chunk)->GetBlocks();
+
+	// Sky light enters the top of the world, block light starts at emitting blocks
+	for (int Y = 0; Y < ChunkSize.Y; ++Y)
+	{
+		for (int X = 0; X < ChunkSize.X; ++X)
+		{
+			if(InChunkPosition.Z >= WorldConfig.MaxChunksZ-1 && !IsOpaque(Blocks.GetBlock({X, Y, ChunkSize.Z-1})))
+			{
+				AddQueues[Sky].Add({Origin + FIntVector(X, Y, ChunkSize.Z-1), MaxLight});
+			}
+			for (int Z = 0; Z < ChunkSize.Z; ++Z)
+			{
+				if(const uint8 Emission = GetEmission(Blocks.GetBlock({X, Y, Z})); Emission > 0)
+				{
+					AddQueues[Block].Add({Origin + FIntVector(X, Y, Z), Emission});
+				}
+			}
+		}
+	}
+
+	// Pull in the light of the loaded neighbors along the shared faces
+	for (int32 Direction = 0; Direction < 6; ++Direction)
+	{
+		const FIntVector Offset = Directions[Direction];
+		const auto neighbor = Chunks->Find(InChunkPosition + Offset);
+		if(neighbor == nullptr || *neighbor == nullptr || !(*neighbor)->bIsReady) continue;
+
+		const int32 Axis = Offset.X != 0 ? 0 : (Offset.Y != 0 ? 1 : 2);
+		const int32 AxisA = (Axis + 1) % 3;
+		const int32 AxisB = (Axis + 2) % 3;
+		for (int B = 0; B < ChunkSize[AxisB]; ++B)
+		{
+			for (int A = 0; A < ChunkSize[AxisA]; ++A)
+			{
+				FIntVector Local;
+				Local[Axis] = Offset[Axis] > 0 ? ChunkSize[Axis] : -1;
+				Local[AxisA] = A;
+				Local[AxisB] = B;
+				AddQueues[Sky].Add({Origin + Local, 0});
+				AddQueues[Block].Add({Origin + Local, 0});
+			}
+		}
+	}
+}
+
+void FLightEngine::UpdateBlock(const FIntVector& InBlockPosition, const FBlock& InOldBlock, const FBlock& InNewBlock)
+{
+	CachedChunk = nullptr;
+	FIntVector Local;
+	UChunk* chunk = FindChunk(InBlockPosition, Local);
+	if(chunk == nullptr) return;
+
+	const bool bIsOpaque = IsOpaque(InNewBlock);
+	for (const EChannel Channel : {Sky, Block})
+	{
+		const uint8 Level = GetLight(Channel, chunk, Local);
+		if(Level > 0 && (bIsOpaque || (Channel == Block && GetEmission(InOldBlock) > 0)))
+		{
+			SetLight(Channel, chunk, Local, 0);
+			RemoveQueues[Channel].Add({InBlockPosition, Level});
+		}
+	}
+
+	if(const uint8 Emission = GetEmission(InNewBlock); Emission > 0)
+	{
+		AddQueues[Block].Add({InBlockPosition, Emission});
+	}
+
+	if(!bIsOpaque)
+	{
+		for (const FIntVector& Direction : Directions)
+		{
+			AddQueues[Sky].Add({InBlockPosition + Direction, 0});
+			AddQueues[Block].Add({InBlockPosition + Direction, 0});
+		}
+		if(InBlockPosition.Z == WorldConfig.GetWorldBlockHeight()-1)
+		{
+			AddQueues[Sky].Add({InBlockPosition, MaxLight});
+		}
+	}
+}
+
+void FLightEngine::Propagate(TSet<FIntVector>& OutChangedChunks)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PropagateLight);
+	CachedChunk = nullptr;
+	for (const EChannel Channel : {Sky, Block})
+	{
+		PropagateRemoval(Channel);
+		PropagateAdd(Channel);
+	}
+	OutChangedChunks.Append(ChangedChunks);
+	ChangedChunks.Reset();
+}
+
+void FLightEngine::PropagateRemoval(const EChannel InChannel)
+{
+	TArray<FLightNode>& Queue = RemoveQueues[InChannel];
+	for (int32 Index = 0; Index < Queue.Num(); ++Index)
+	{
+		const FLightNode Node = Queue[Index];
+		for (int32 Direction = 0; Direction < 6; ++Direction)
+		{
+			const FIntVector Position = Node.Position + Directions[Direction];
+			FIntVector Local;
+			UChunk* chunk = FindChunk(Position, Local);
+			if(chunk == nullptr) continue;
+
+			const uint8 Level = GetLight(InChannel, chunk, Local);
+			if(Level == 0) continue;
+
+			const bool bIsSkyColumn = InChannel == Sky && Direction == Down && Node.Level == MaxLight;
+			if(Level < Node.Level || (bIsSkyColumn && Level == MaxLight))
+			{
+				SetLight(InChannel, chunk, Local, 0);
+				Queue.Add({Position, Level});
+				if(const uint8 Emission = GetEmission(chunk->GetBlocks().GetBlock(Local)); InChannel == Block && Emission > 0)
+				{
+					AddQueues[Block].Add({Position, Emission});
+				}
+			} else
+			{
+				// Lit from somewhere else, fill the removed area again from here
+				AddQueues[InChannel].Add({Position, 0});
+			}
+		}
+	}
+	Queue.Reset();
+}
+
+void FLightEngine::PropagateAdd(const EChannel InChannel)
+{
+	TArray<FLightNode>& Queue = AddQueues[InChannel];
+	for (int32 Index = 0; Index < Queue.Num(); ++Index)
+	{
+		const FLightNode Node = Queue[Index];
+		FIntVector Local;
+		UChunk* chunk = FindChunk(Node.Position, Local);
+		if(chunk == nullptr) continue;
+
+		uint8 Level = GetLight(InChannel, chunk, Local);
+		if(Node.Level > Level)
+		{
+			if(IsOpaque(chunk->GetBlocks().GetBlock(Local)) && InChannel == Sky) continue;
+			SetLight(InChannel, chunk, Local, Node.Level);
+			Level = Node.Level;
+		}
+		if(Level <= 1) continue;
+
+		for (int32 Direction = 0; Direction < 6; ++Direction)
+		{
+			const FIntVector Position = Node.Position + Directions[Direction];
+			FIntVector NeighborLocal;
+			UChunk* neighbor = FindChunk(Position, NeighborLocal);
+			if(neighbor == nullptr || IsOpaque(neighbor->GetBlocks().GetBlock(NeighborLocal))) continue;
+
+			const uint8 NewLevel = InChannel == Sky && Direction == Down && Level == MaxLight ? MaxLight : Level - 1;
+			if(GetLight(InChannel, neighbor, NeighborLocal) < NewLevel)
+			{
+				SetLight(InChannel, neighbor, NeighborLocal, NewLevel);
+				Queue.Add({Position, 0});
+			}
+		}
+	}
+	Queue.Reset();
+}
+
+UChunk* FLightEngine::FindChunk(const FIntVector& InBlockPosition, FIntVector& OutLocalPosition)
+{
+	const FIntVector ChunkSize = WorldConfig.ChunkSize;
+	const FIntVector ChunkPosition(	FloorDivide(InBlockPosition.X, ChunkSize.X),
+									FloorDivide(InBlockPosition.Y, ChunkSize.Y),
+									FloorDivide(InBlockPosition.Z, ChunkSize.Z));
+	if(CachedChunk == nullptr || CachedChunkPosition != ChunkPosition)
+	{
+		const auto chunk = Chunks->Find(ChunkPosition);
+		CachedChunk = chunk != nullptr && *chunk != nullptr && (*chunk)->bIsReady ? *chunk : nullptr;
+		CachedChunkPosition = ChunkPosition;
+	}
+	OutLocalPosition = InBlockPosition - FIntVector(ChunkPosition.X * ChunkSize.X, ChunkPosition.Y * ChunkSize.Y, ChunkPosition.Z * ChunkSize.Z);
+	return CachedChunk;
+}
+
+bool FLightEngine::IsOpaque(const FBlock& InBlock) const
+{
+	return InBlock != Air && WorldConfig.BlockTypes.IsValidIndex(InBlock.BlockTypeID) && WorldConfig.BlockTypes[InBlock.BlockTypeID].bIsSolid;
+}
+
+uint8 FLightEngine::GetEmission(const FBlock& InBlock) const
+{
+	return InBlock != Air && WorldConfig.BlockTypes.IsValidIndex(InBlock.BlockTypeID) ? FMath::Min(WorldConfig.BlockTypes[InBlock.BlockTypeID].LightEmission, MaxLight) : 0;
+}
+
+uint8 FLightEngine::GetLight(const EChannel InChannel, const UChunk* InChunk, const FIntVector& InLocalPosition)
+{
+	return InChannel == Sky ? InChunk->GetBlocks().GetSkyLight(InLocalPosition) : InChunk->GetBlocks().GetBlockLight(InLocalPosition);
+}
+
+void FLightEngine::SetLight(const EChannel InChannel, UChunk* InChunk, const FIntVector& InLocalPosition, const uint8 InLevel)
+{
+	if(InChannel == Sky)
+	{
+		InChunk->GetMutableBlocks().SetSkyLight(InLocalPosition, InLevel);
+	} else
+	{
+		InChunk->GetMutableBlocks().SetBlockLight(InLocalPosition, InLevel);
+	}
+	const FIntVector& ChunkPosition = InChunk->GetChunkConfig().Position;
+	ChangedChunks.Add(ChunkPosition);
+	// Faces of the neighbor on this border are lit by this cell
+	const FIntVector& ChunkSize = WorldConfig.ChunkSize;
+	if(InLocalPosition.X == 0) ChangedChunks.Add(ChunkPosition+FIntVector(-1,0,0));
+	if(InLocalPosition.Y == 0) ChangedChunks.Add(ChunkPosition+FIntVector(0,-1,0));
+	if(InLocalPosition.Z == 0) ChangedChunks.Add(ChunkPosition+FIntVector(0,0,-1));
+	if(InLocalPosition.X == ChunkSize.X-1) ChangedChunks.Add(ChunkPosition+FIntVector(1,0,0));
+	if(InLocalPosition.Y == ChunkSize.Y-1) ChangedChunks.Add(ChunkPosition+FIntVector(0,1,0));
+	if(InLocalPosition.Z == ChunkSize.Z-1) ChangedChunks.Add(ChunkPosition+FIntVector(0,0,1));
+}
@@ -2,9 +2,18 @@
 
 
 #include "World/SimpleGenerator.h"
+#include "Globals.h"
 
 #include "IStereoLayers.h"
 
+DECLARE_CYCLE_STAT(TEXT("Generate simple chunk"), STAT_SimpleGenerator, STATGROUP_CubicWorld);
+
+namespace
+{
+	// Distortion noise moves the layer borders up by at most this much
+	constexpr float MaxDistortion = 0.25f;
+}
+
 void USimpleGenerator::Init()
 {
 	Noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
@@ -44,7 +53,7 @@ TOptional<FBlock> USimpleGenerator::GetTile(const FIntVector& Position, const FW
 	const int MaxHeight = WorldConfig.GetWorldBlockHeight();
 	if(const int noiseHeight = round(GetNoise(static_cast<float>(Position.X),static_cast<float>(Position.Y)) * MaxHeight); noiseHeight >= Position.Z)
 	{
-		const float distortionNoiseHeight = (DistortionNoise.GetNoise(static_cast<float>(Position.X),static_cast<float>(Position.Y))/2.0f + 0.5f)*0.25;
+		const float distortionNoiseHeight = (DistortionNoise.GetNoise(static_cast<float>(Position.X),static_cast<float>(Position.Y))/2.0f + 0.5f)*MaxDistortion;
 		const float blockHeightPercentage = static_cast<float>(Position.Z)/MaxHeight;
 
 		for (const auto layer : Layers)
@@ -61,4 +70,129 @@ TOptional<FBlock> USimpleGenerator::GetTile(const FIntVector& Position, const FW
 		}
 	}
 	return TOptional<FBlock>();
+}
+
+void USimpleGenerator::GetColumnHeights(const FChunkConfig& ChunkConfig, TArray<int32>& OutHeights)
+{
+	const FIntVector& ChunkSize = ChunkConfig.WorldConfig.ChunkSize;
+	const FIntVector ChunkOrigin = ChunkConfig.GetChunkPositionInBlocks();
+	const int MaxHeight = ChunkConfig.WorldConfig.GetWorldBlockHeight();
+
+	TArray<float> noise;
+	noise.SetNumUninitialized(ChunkSize.X * ChunkSize.Y);
+	Noise.GetNoiseGrid2D(noise.GetData(), ChunkOrigin.X, ChunkOrigin.Y, ChunkSize.X, ChunkSize.Y);
+	OutHeights.SetNumUninitialized(noise.Num());
+	for (int32 index = 0; index < noise.Num(); ++index)
+	{
+		OutHeights[index] = round(FMath::Pow(noise[index]/2.0f + 0.5f, NoiseConfig.Power) * MaxHeight);
+	}
+}
+
+int32 USimpleGenerator::GetLayerTop(const float LayerHeight, const int32 MaxHeight)
+{
+	// Same comparison as GetTile, the estimate can be off by one from float rounding
+	auto IsInLayer = [&](const int32 Z) { return static_cast<float>(Z)/MaxHeight < LayerHeight; };
+	int32 Z = FMath::CeilToInt(LayerHeight * MaxHeight);
+	while (IsInLayer(Z)) ++Z;
+	while (Z > 0 && !IsInLayer(Z - 1)) --Z;
+	return Z;
+}
+
+void USimpleGenerator::FillLayerColumn(const FChunkConfig& ChunkConfig, TChunkData& Blocks, const int32 X, const int32 Y, const int32 ColumnHeight, const TArray<FBlockLayer>& Layers, const float Distortion)
+{
+	const int32 ChunkBottom = ChunkConfig.GetChunkPositionInBlocks().Z;
+	const int32 columnTop = FMath::Min(ColumnHeight, ChunkBottom + ChunkConfig.WorldConfig.ChunkSize.Z - 1);
+	const int MaxHeight = ChunkConfig.WorldConfig.GetWorldBlockHeight();
+
+	// Layers are sorted, so each one is a single run on top of the previous
+	int32 Z = ChunkBottom;
+	for (int32 layerIndex = 0; layerIndex < Layers.Num() && Z <= columnTop; ++layerIndex)
+	{
+		const FBlockLayer& layer = Layers[layerIndex];
+		const int32 layerTop = FMath::Min(GetLayerTop(layer.Height + Distortion, MaxHeight) - 1, columnTop);
+		if(layerTop < Z) continue;
+		if(layer.bTopBlockDiffers && layerTop == ColumnHeight)
+		{
+			Blocks.FillColumn(X, Y, Z - ChunkBottom, layerTop - 1 - ChunkBottom, FBlock(layer.BlockTypeId));
+			Blocks.FillColumn(X, Y, layerTop - ChunkBottom, layerTop - ChunkBottom, FBlock(layer.TopBlockTypeId));
+		}
+		else
+		{
+			Blocks.FillColumn(X, Y, Z - ChunkBottom, layerTop - ChunkBottom, FBlock(layer.BlockTypeId));
+		}
+		Z = layerTop + 1;
+	}
+}
+
+void USimpleGenerator::GenerateChunk(const FChunkConfig& ChunkConfig, TChunkData& Blocks)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SimpleGenerator);
+	if(!bHasBeenInitialized) Init();
+	const FIntVector& ChunkSize = ChunkConfig.WorldConfig.ChunkSize;
+	const FIntVector ChunkOrigin = ChunkConfig.GetChunkPositionInBlocks();
+	const int32 ChunkTop = ChunkOrigin.Z + ChunkSize.Z - 1;
+
+	TArray<int32> Heights;
+	GetColumnHeights(ChunkConfig, Heights);
+	const int32 maxColumnHeight = FMath::Max(Heights);
+	if(ChunkOrigin.Z > maxColumnHeight) return;
+
+	const int32 minColumnHeight = FMath::Min(Heights);
+	if(ChunkTop < minColumnHeight)
+	{
+		if(const TOptional<FBlock> fill = GetSolidFill(ChunkConfig, ChunkOrigin.Z, ChunkTop); fill.IsSet())
+		{
+			for (FBlock& block : Blocks)
+			{
+				if(block == Air) block = fill.GetValue();
+			}
+			return;
+		}
+	}
+
+	TArray<float> Distortions;
+	Distortions.SetNumUninitialized(ChunkSize.X * ChunkSize.Y);
+	DistortionNoise.GetNoiseGrid2D(Distortions.GetData(), ChunkOrigin.X, ChunkOrigin.Y, ChunkSize.X, ChunkSize.Y);
+
+	for (int Y = 0; Y < ChunkSize.Y; ++Y)
+	{
+		for (int X = 0; X < ChunkSize.X; ++X)
+		{
+			const float distortionNoiseHeight = (Distortions[Y * ChunkSize.X + X]/2.0f + 0.5f)*MaxDistortion;
+			FillLayerColumn(ChunkConfig, Blocks, X, Y, Heights[Y * ChunkSize.X + X], Layers, distortionNoiseHeight);
+		}
+	}
+}
+
+bool USimpleGenerator::GetHeightRange(const FChunkConfig& ChunkConfig, int32& OutMinHeight, int32& OutMaxHeight)
+{
+	if(!bHasBeenInitialized) Init();
+	TArray<int32> Heights;
+	GetColumnHeights(ChunkConfig, Heights);
+	OutMinHeight = FMath::Min(Heights);
+	OutMaxHeight = FMath::Max(Heights);
+	// The grid can round differently from GetNoise when the compiler fuses multiply adds
+	OutMinHeight -= 1;
+	OutMaxHeight += 1;
+	return true;
+}
+
+TOptional<FBlock> USimpleGenerator::GetSolidFill(const FChunkConfig& ChunkConfig, const int32 MinZ, const int32 MaxZ)
+{
+	if(!bHasBeenInitialized) Init();
+	const int MaxHeight = ChunkConfig.WorldConfig.GetWorldBlockHeight();
+	const float minPercentage = static_cast<float>(MinZ)/MaxHeight;
+	const float maxPercentage = static_cast<float>(MaxZ)/MaxHeight;
+
+	// The first layer GetTile picks for any distortion, lower layers must not reach the range even fully distorted
+	float lowerLayerHeight = TNumericLimits<float>::Lowest();
+	for (const auto layer : Layers)
+	{
+		if(maxPercentage < layer.Height)
+		{
+			return minPercentage >= lowerLayerHeight + MaxDistortion ? TOptional(FBlock(layer.BlockTypeId)) : TOptional<FBlock>();
+		}
+		lowerLayerHeight = layer.Height;
+	}
+	return TOptional<FBlock>();
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/StructureStage.h"
+#include "Globals.h"
+
+UStructureStage::UStructureStage()
+{
+	DependencyRadius = 1;
+	bDependsOnWholeColumns = true;
+}
+
+int32 UStructureStage::FindGround(const FChunkConfig& ChunkConfig, const TChunkData& Blocks, const FGeneratorStageNeighbors& Neighbors, const int32 X, const int32 Y, FBlock& OutGround) const
+{
+	const FIntVector& ChunkSize = ChunkConfig.WorldConfig.ChunkSize;
+	const int32 ChunkX = FloorDivide(X, ChunkSize.X);
+	const int32 ChunkY = FloorDivide(Y, ChunkSize.Y);
+	const int32 LocalX = X - ChunkX * ChunkSize.X;
+	const int32 LocalY = Y - ChunkY * ChunkSize.Y;
+	for (int32 ChunkZ = ChunkConfig.WorldConfig.MaxChunksZ - 1; ChunkZ >= 0; --ChunkZ)
+	{
+		const FIntVector position(ChunkX, ChunkY, ChunkZ);
+		const TChunkData* chunk = position == ChunkConfig.Position ? &Blocks : Neighbors.GetChunk(position);
+		if(chunk == nullptr) return INDEX_NONE;
+		for (int32 Z = ChunkSize.Z - 1; Z >= 0; --Z)
+		{
+			if(const FBlock block = chunk->GetBlock(FIntVector(LocalX, LocalY, Z)); block != Air && !IsStructureBlock(block))
+			{
+				OutGround = block;
+				return ChunkZ * ChunkSize.Z + Z;
+			}
+		}
+	}
+	return INDEX_NONE;
+}
+
+void UStructureStage::Generate(const FChunkConfig& ChunkConfig, TChunkData& Blocks, const FGeneratorStageNeighbors& Neighbors)
+{
+	const FIntVector& ChunkSize = ChunkConfig.WorldConfig.ChunkSize;
+	const FIntVector ChunkOrigin = ChunkConfig.GetChunkPositionInBlocks();
+	const int32 Size = FMath::Max(RegionSize, 1);
+	// Neighbors further away are not available, structures reaching past them get cut off
+	const int32 Reach = FMath::Clamp(GetMaxReach(), 0, FMath::Min(ChunkSize.X, ChunkSize.Y) * FMath::Max(DependencyRadius, 0));
+
+	// Every chunk goes through the regions in the same order, so overlapping structures end up the same on both sides of a border
+	TArray<TPair<FIntVector, FBlock>> structure;
+	for (int32 RegionY = FloorDivide(ChunkOrigin.Y - Reach, Size); RegionY <= FloorDivide(ChunkOrigin.Y + ChunkSize.Y - 1 + Reach, Size); ++RegionY)
+	{
+		for (int32 RegionX = FloorDivide(ChunkOrigin.X - Reach, Size); RegionX <= FloorDivide(ChunkOrigin.X + ChunkSize.X - 1 + Reach, Size); ++RegionX)
+		{
+			FRandomStream random(static_cast<int32>(HashCombine(HashCombine(GetTypeHash(Seed), GetTypeHash(RegionX)), GetTypeHash(RegionY))));
+			if(random.FRand() >= Chance) continue;
+
+			const int32 X = RegionX * Size + random.RandHelper(Size);
+			const int32 Y = RegionY * Size + random.RandHelper(Size);
+			if(X < ChunkOrigin.X - Reach || X >= ChunkOrigin.X + ChunkSize.X + Reach || Y < ChunkOrigin.Y - Reach || Y >= ChunkOrigin.Y + ChunkSize.Y + Reach) continue;
+
+			FBlock groundBlock;
+			const int32 ground = FindGround(ChunkConfig, Blocks, Neighbors, X, Y, groundBlock);
+			if(ground == INDEX_NONE) continue;
+			if(GroundBlockTypeId != UINT8_MAX && groundBlock.BlockTypeID != GroundBlockTypeId) continue;
+
+			structure.Reset();
+			PlaceStructure(FIntVector(X, Y, ground + 1), random, structure);
+			for (const TPair<FIntVector, FBlock>& block : structure)
+			{
+				const FIntVector local = block.Key - ChunkOrigin;
+				if(local.X < 0 || local.X >= ChunkSize.X || local.Y < 0 || local.Y >= ChunkSize.Y || local.Z < 0 || local.Z >= ChunkSize.Z) continue;
+				if(Blocks.GetBlock(local) == Air)
+				{
+					Blocks.SetBlock(local, block.Value);
+				}
+			}
+		}
+	}
+}
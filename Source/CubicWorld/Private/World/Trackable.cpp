@@ -26,5 +26,35 @@ void UTrackable::BeginPlay()
 void UTrackable::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if(GetOwner() != nullptr && DeltaTime > 0.0f)
+	{
+		const FVector Location = GetOwner()->GetActorLocation();
+		if(bHasLastLocation)
+		{
+			Velocity = FMath::Lerp(Velocity, (Location - LastLocation) / DeltaTime, FMath::Min(DeltaTime * 4.0f, 1.0f));
+		}
+		LastLocation = Location;
+		bHasLastLocation = true;
+	}
+	if(bUseViewDirection && GetOwner() != nullptr)
+	{
+		// Pawns report the camera of their controller here
+		FVector EyesLocation;
+		FRotator EyesRotation;
+		GetOwner()->GetActorEyesViewPoint(EyesLocation, EyesRotation);
+		ViewDirection = EyesRotation.Vector();
+	}
+}
+
+float UTrackable::GetChunkPriority(const FVector& InTrackablePosition, const FVector& InChunkPosition) const
+{
+	const FVector Offset = InChunkPosition - InTrackablePosition;
+	const float Distance = Offset.Size();
+	// The chunks around the trackable are needed whatever it looks at
+	if(!bUseViewDirection || Distance <= 1.5f) return Distance;
+
+	const float Cos = FVector::DotProduct(Offset / Distance, ViewDirection);
+	const float ConeCos = FMath::Cos(FMath::DegreesToRadians(ViewConeHalfAngle));
+	return Cos >= ConeCos ? Distance : Distance * (1.0f + ViewPriorityWeight * (ConeCos - Cos));
 }
 
@@ -0,0 +1,45 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "World/TreeStage.h"
+
+bool UTreeStage::ShouldGenerate(const FChunkConfig& ChunkConfig) const
+{
+	return Super::ShouldGenerate(ChunkConfig) && TrunkBlockTypeId != UINT8_MAX;
+}
+
+int32 UTreeStage::GetMaxReach() const
+{
+	return LeavesBlockTypeId == UINT8_MAX ? 0 : FMath::Max(LeavesRadius, 0);
+}
+
+bool UTreeStage::IsStructureBlock(const FBlock& InBlock) const
+{
+	return InBlock.BlockTypeID == TrunkBlockTypeId || (LeavesBlockTypeId != UINT8_MAX && InBlock.BlockTypeID == LeavesBlockTypeId);
+}
+
+void UTreeStage::PlaceStructure(const FIntVector& InOrigin, FRandomStream& InRandom, TArray<TPair<FIntVector, FBlock>>& OutBlocks) const
+{
+	const int32 TrunkHeight = InRandom.RandRange(MinTrunkHeight, FMath::Max(MinTrunkHeight, MaxTrunkHeight));
+	for (int32 Z = 0; Z < TrunkHeight; ++Z)
+	{
+		OutBlocks.Add({InOrigin + FIntVector(0, 0, Z), FBlock(TrunkBlockTypeId)});
+	}
+	if(LeavesBlockTypeId == UINT8_MAX) return;
+
+	// Trunk blocks come first, so the leaves don't replace them
+	const FIntVector Center = InOrigin + FIntVector(0, 0, TrunkHeight - 1);
+	for (int32 Z = -LeavesRadius; Z <= LeavesRadius; ++Z)
+	{
+		for (int32 Y = -LeavesRadius; Y <= LeavesRadius; ++Y)
+		{
+			for (int32 X = -LeavesRadius; X <= LeavesRadius; ++X)
+			{
+				if(X * X + Y * Y + Z * Z <= LeavesRadius * (LeavesRadius + 1))
+				{
+					OutBlocks.Add({Center + FIntVector(X, Y, Z), FBlock(LeavesBlockTypeId)});
+				}
+			}
+		}
+	}
+}
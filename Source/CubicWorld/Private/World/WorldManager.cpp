@@ -7,6 +7,8 @@
 
 #include "Globals.h"
 #include "IContentBrowserSingleton.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
 #include "Kismet/GameplayStatics.h"
 #include "Mesh/ChunkMesh.h"
 #include "World/SimpleGenerator.h"
@@ -18,6 +20,15 @@ DECLARE_CYCLE_STAT(TEXT("Generate chunk meshes"), STAT_GenerateChunkMeshes, STAT
 DECLARE_CYCLE_STAT(TEXT("render chunks"), STAT_Render, STATGROUP_CubicWorld);
 DECLARE_CYCLE_STAT(TEXT("Unload chunk meshes"), STAT_UnloadChunks, STATGROUP_CubicWorld);
 DECLARE_CYCLE_STAT(TEXT("Check chunks to unload"), STAT_CheckChunksToUnload, STATGROUP_CubicWorld);
+DECLARE_CYCLE_STAT(TEXT("Update section visibility"), STAT_UpdateSectionVisibility, STATGROUP_CubicWorld);
+DECLARE_CYCLE_STAT(TEXT("Update chunk collision"), STAT_UpdateChunkCollision, STATGROUP_CubicWorld);
+DECLARE_CYCLE_STAT(TEXT("Update chunk occlusion"), STAT_UpdateChunkOcclusion, STATGROUP_CubicWorld);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Occluded chunk meshes"), STAT_OccludedChunkMeshes, STATGROUP_CubicWorld);
+DECLARE_CYCLE_STAT(TEXT("Edit blocks"), STAT_EditBlocks, STATGROUP_CubicWorld);
+DECLARE_CYCLE_STAT(TEXT("Block ticks"), STAT_BlockTicks, STATGROUP_CubicWorld);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred chunk loads"), STAT_DeferredChunkLoads, STATGROUP_CubicWorld);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred chunk meshes"), STAT_DeferredChunkMeshes, STATGROUP_CubicWorld);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred chunk unloads"), STAT_DeferredChunkUnloads, STATGROUP_CubicWorld);
 
 AWorldManager::AWorldManager()
 {
@@ -34,7 +45,26 @@ AWorldManager::~AWorldManager()
 		delete GeneratorRunner;
 		GeneratorRunner = nullptr;
 	}
-	
+	if(InterestManager != nullptr)
+	{
+		delete InterestManager;
+		InterestManager = nullptr;
+	}
+	if(LightEngine != nullptr)
+	{
+		delete LightEngine;
+		LightEngine = nullptr;
+	}
+	if(FluidSimulation != nullptr)
+	{
+		delete FluidSimulation;
+		FluidSimulation = nullptr;
+	}
+	if(BlockTickScheduler != nullptr)
+	{
+		delete BlockTickScheduler;
+		BlockTickScheduler = nullptr;
+	}
 }
 
 
@@ -50,6 +80,29 @@ void AWorldManager::BeginPlay()
 	}
 
 	GeneratorRunner = new FGeneratorRunner(Generator, WorldConfig);
+	InterestManager = new FInterestManager(WorldConfig);
+	if(WorldConfig.bBakeLighting)
+	{
+		LightEngine = new FLightEngine(&Chunks, WorldConfig);
+	}
+	if(WorldConfig.bSimulateFluids)
+	{
+		FluidSimulation = new FFluidSimulation(&Chunks, WorldConfig);
+	}
+
+	BlockTickHandlers.Init(nullptr, WorldConfig.BlockTypes.Num());
+	for (int32 Index = 0; Index < WorldConfig.BlockTypes.Num(); ++Index)
+	{
+		if(const FBlockType& BlockType = WorldConfig.BlockTypes[Index]; BlockType.TickHandler != nullptr)
+		{
+			BlockTickHandlers[Index] = NewObject<UBlockTickHandler>(this, BlockType.TickHandler);
+			bHasRandomTicks |= BlockType.bRandomTicks;
+			if(BlockTickScheduler == nullptr)
+			{
+				BlockTickScheduler = new FBlockTickScheduler(WorldConfig);
+			}
+		}
+	}
 
 	ChunkStorage = NewObject<UChunkStorage>();
 }
@@ -81,9 +134,15 @@ void AWorldManager::Tick(const float DeltaTime)
 	Super::Tick(DeltaTime);
 	UpdateVisibleChunks();
 	GenerateChunks();
+	UpdateFluids(DeltaTime);
+	UpdateBlockTicks(DeltaTime);
+	UpdateLighting();
 	GenerateChunkMeshes();
 	UnloadChunks();
 	ChunksToLoad.Reset();
+	UpdateChunkMeshSectionVisibility();
+	UpdateChunkMeshOcclusion();
+	UpdateChunkMeshCollision();
 }
 
 
@@ -100,9 +159,10 @@ void AWorldManager::UpdateVisibleChunks()
 {
 	SCOPE_CYCLE_COUNTER(STAT_UpdateVisibleChunks);
 	SCOPED_NAMED_EVENT(AWorldManager_UpdateVisibleChunks, FColor::Blue);
+	TSet<TObjectKey<UTrackable>> Tracked;
 	for (const auto trackable : TrackerComponents)
 	{
-		if (trackable->bIsTrackable)
+		if (trackable != nullptr && trackable->bIsTrackable && trackable->GetOwner() != nullptr)
 		{
 			const uint8 distance = std::clamp(trackable->ChunkRenderDistance, static_cast<uint8>(1), WorldConfig.MaxChunkRenderDistance);
 			const FIntVector position = WorldToLocalPosition(trackable->GetOwner()->GetActorLocation());
@@ -111,65 +171,142 @@ void AWorldManager::UpdateVisibleChunks()
 				UE_LOG(LogTemp, Warning, TEXT("Position: %s"), *position.ToString());
 
 			trackable->LastWorldPosition = position;
+			InterestManager->UpdateViewer(trackable, trackable->GetOwner()->GetActorLocation() / WorldConfig.GetChunkWorldSize(), distance);
+			Tracked.Add(trackable);
+		}
+	}
+	InterestManager->RemoveViewersExcept(Tracked);
+	UpdatePrefetchChunks();
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CheckChunksToUnload);
+		SCOPED_NAMED_EVENT(AWorldManager_CheckChunksToUnload, FColor::Blue);
+		TSet<FIntPoint> KeepChanged;
+		TSet<FIntPoint> VisibleChanged;
+		InterestManager->ConsumeChanges(KeepChanged, VisibleChanged);
+		for (const FIntPoint& column : KeepChanged)
+		{
+			const bool bIsKept = InterestManager->HasInterest(column, FInterestManager::Keep);
 			for (int Z = 0; Z < WorldConfig.MaxChunksZ; ++Z)
 			{
-				for (int Y = -distance-1; Y <= distance+1; ++Y)
+				const FIntVector chunkPosition(column.X, column.Y, Z);
+				if(bIsKept)
 				{
-					for (int X = -distance-1; X <= distance+1; ++X)
-					{
-						FIntVector ChunkToLoad{position.X+X, position.Y+Y, Z};
-						const int32 index = ChunksToLoad.Find(ChunkToLoad); 
-						if(index == INDEX_NONE && Chunks.Find(ChunkToLoad) == nullptr)
-						{
-							ChunksToLoad.Add(ChunkToLoad);
-							ChunksToUnload.Remove(ChunkToLoad);
-							if(abs(Y) <= distance && abs(X) <= distance)
-                            {
-                            	VisibleChunks.Add(ChunkToLoad);
-                            }
-						}else if(abs(Y) <= distance && abs(X) <= distance && VisibleChunks.Find(ChunkToLoad) == nullptr)
-						{
-							VisibleChunks.Add(ChunkToLoad);
-							ChunkMeshesToGenerate.Enqueue(ChunkToLoad);
-						}
-					}
-				}	
+					ChunksToUnload.Remove(chunkPosition);
+				}
+				else if(Chunks.Contains(chunkPosition))
+				{
+					ChunksToUnload.Add(chunkPosition);
+				}
 			}
-			auto SortPredicate = [&](const FIntVector& A, const FIntVector& B)->bool
+		}
+		for (const FIntPoint& column : VisibleChanged)
+		{
+			if(!InterestManager->HasInterest(column, FInterestManager::Visible)) continue;
+			for (int Z = 0; Z < WorldConfig.MaxChunksZ; ++Z)
 			{
-				const FVector Trackable = FVector(trackable->LastWorldPosition);
-				const float ADist = FVector::Distance(Trackable, FVector(A));
-				const float BDist = FVector::Distance(Trackable, FVector(B));
-				return ADist < BDist;
-			};
-			ChunksToLoad.Sort(SortPredicate);
+				const FIntVector chunkPosition(column.X, column.Y, Z);
+				bool bWasVisible = false;
+				VisibleChunks.Add(chunkPosition, &bWasVisible);
+				if(!bWasVisible && Chunks.Contains(chunkPosition))
+				{
+					ChunkMeshesToGenerate.Enqueue(chunkPosition);
+				}
+			}
 		}
 	}
+
+	// Already sorted for each trackable and interleaved between them
+	TArray<FIntPoint> Columns;
+	InterestManager->GetColumnsToLoad(WorldConfig.MaxColumnLoadsPerTick, [this](const FIntPoint& InColumn)
 	{
-		SCOPE_CYCLE_COUNTER(STAT_CheckChunksToUnload);
-		SCOPED_NAMED_EVENT(AWorldManager_CheckChunksToUnload, FColor::Blue);
-		// Check chunks to unload
-		for (auto chunk : Chunks)
+		// A column cut off by the load budget or partly unloaded before it was wanted again is missing some chunks
+		for (int Z = 0; Z < WorldConfig.MaxChunksZ; ++Z)
+		{
+			if(!Chunks.Contains(FIntVector(InColumn.X, InColumn.Y, Z))) return false;
+		}
+		return true;
+	}, Columns);
+	for (const FIntPoint& column : Columns)
+	{
+		for (int Z = 0; Z < WorldConfig.MaxChunksZ; ++Z)
 		{
-			bool shouldUnload = true;
-			for (const auto trackable : TrackerComponents)
+			if(const FIntVector chunkPosition(column.X, column.Y, Z); !Chunks.Contains(chunkPosition))
 			{
-				if(!trackable->bIsTrackable)break;
-				
-				const float distance = std::clamp(FVector(trackable->ChunkRenderDistance,trackable->ChunkRenderDistance,0).Length(), 1.0, FVector(WorldConfig.MaxChunkRenderDistance,WorldConfig.MaxChunkRenderDistance,0).Length());
-				const FIntVector position = WorldToLocalPosition(trackable->GetOwner()->GetActorLocation());
-					
-				const float distanceToTrackable = FVector::Distance(FVector(position.X, position.Y, 0.0f), FVector(chunk.Key.X, chunk.Key.Y, 0.0f));
-				if(distanceToTrackable <= distance+4)
-				{
-					shouldUnload = false;
-				}
+				ChunksToLoad.Add(chunkPosition);
+				ChunksToUnload.Remove(chunkPosition);
 			}
-			if(shouldUnload)
+		}
+	}
+}
+
+void AWorldManager::UpdatePrefetchChunks()
+{
+	const FVector ChunkWorldSize = WorldConfig.GetChunkWorldSize();
+	for (const auto trackable : TrackerComponents)
+	{
+		if(trackable == nullptr || !trackable->bIsTrackable || trackable->GetOwner() == nullptr) continue;
+
+		// Only the horizontal movement matters, all chunks of a column are loaded anyway
+		TSet<FIntPoint> Columns;
+		const FVector Velocity = FVector(trackable->Velocity.X, trackable->Velocity.Y, 0.0f) / ChunkWorldSize;
+		const float Distance = Velocity.Size() * trackable->PrefetchSeconds;
+		if(Distance >= 1.0f)
+		{
+			const int32 RenderDistance = std::clamp(trackable->ChunkRenderDistance, static_cast<uint8>(1), WorldConfig.MaxChunkRenderDistance);
+			const FVector Direction = Velocity.GetSafeNormal();
+			const FVector Side(-Direction.Y, Direction.X, 0.0f);
+			const FVector Start = trackable->GetOwner()->GetActorLocation() / ChunkWorldSize;
+			// The leading edge of the render window at every chunk along the path
+			for (int32 Step = 1; Step <= FMath::CeilToInt(Distance); ++Step)
 			{
-				ChunksToUnload.Add(chunk.Key);
+				const FVector Edge = Start + Direction * (RenderDistance + FMath::Min<float>(Step, Distance));
+				for (int32 Offset = -RenderDistance; Offset <= RenderDistance; ++Offset)
+				{
+					const FVector Column = Edge + Side * Offset;
+					Columns.Add(FIntPoint(FMath::RoundToInt(Column.X), FMath::RoundToInt(Column.Y)));
+				}
 			}
 		}
+		// A changed path drops the old columns, chunks still waiting for the generator are cancelled on unload
+		InterestManager->SetPrefetchColumns(trackable, Columns);
+	}
+}
+
+void AWorldManager::SortByChunkPriority(TArray<FIntVector>& InOutChunkPositions) const
+{
+	if(InOutChunkPositions.Num() < 2) return;
+
+	TArray<TPair<const UTrackable*, FVector>> Trackables;
+	for (const auto trackable : TrackerComponents)
+	{
+		if(trackable->bIsTrackable && trackable->GetOwner() != nullptr)
+		{
+			Trackables.Emplace(trackable, trackable->GetOwner()->GetActorLocation() / WorldConfig.GetChunkWorldSize());
+		}
+	}
+	if(Trackables.IsEmpty()) return;
+
+	TArray<TPair<float, FIntVector>> Priorities;
+	Priorities.Reserve(InOutChunkPositions.Num());
+	for (const FIntVector& chunkPosition : InOutChunkPositions)
+	{
+		// Chunk meshes are centered in XY and start at the bottom in Z
+		const FVector ChunkCenter(chunkPosition.X, chunkPosition.Y, chunkPosition.Z + 0.5f);
+		float Priority = MAX_flt;
+		for (const auto& trackable : Trackables)
+		{
+			Priority = FMath::Min(Priority, trackable.Key->GetChunkPriority(trackable.Value, ChunkCenter));
+		}
+		Priorities.Emplace(Priority, chunkPosition);
+	}
+	Priorities.StableSort([](const TPair<float, FIntVector>& A, const TPair<float, FIntVector>& B)
+	{
+		return A.Key < B.Key;
+	});
+	for (int32 Index = 0; Index < Priorities.Num(); ++Index)
+	{
+		InOutChunkPositions[Index] = Priorities[Index].Value;
 	}
 }
 
@@ -179,8 +316,14 @@ void AWorldManager::GenerateChunks()
 	SCOPED_NAMED_EVENT(AWorldManager_GenerateChunks, FColor::Blue);
 	{
 		SCOPED_NAMED_EVENT(AWorldManager_SendChunksToGeneratorRunner, FColor::Blue);
+		// Sorted by priority, what doesn't fit is found again by the next UpdateVisibleChunks
+		const FTickBudget Budget(WorldConfig.LoadChunksBudget);
+		int32 Sent = 0;
 		for (auto chunkPosition : ChunksToLoad)
 		{
+			if(Sent > 0 && Budget.IsExceeded()) break;
+			Sent++;
+
 			const FChunkConfig chunkConfig = FChunkConfig(WorldConfig, chunkPosition);
 			UChunk* chunk = NewObject<UChunk>();
 			chunk->SetChunkConfig(chunkConfig);
@@ -192,19 +335,25 @@ void AWorldManager::GenerateChunks()
 				GeneratorRunner->Results.Enqueue({chunkPosition, tiles.GetValue()});
 			} else
 			{
-				GeneratorRunner->Tasks.Enqueue({chunkPosition, TChunkData(chunkConfig.WorldConfig.ChunkSize)});
+				GeneratorRunner->AddTask(chunkPosition, TChunkData(chunkConfig.WorldConfig.ChunkSize));
 			}
 		}
+		SET_DWORD_STAT(STAT_DeferredChunkLoads, ChunksToLoad.Num() - Sent);
 	}
 
 	{
 		TPair<FIntVector, TChunkData> tiles;
 		SCOPED_NAMED_EVENT(AWorldManager_GetGeneratedBlocks, FColor::Blue);
-		while (GeneratorRunner->Results.Dequeue(tiles))
+		const FTickBudget Budget(WorldConfig.GeneratedChunksBudget);
+		while (!Budget.IsExceeded() && GeneratorRunner->Results.Dequeue(tiles))
 		{
 			if(UChunk** chunk = Chunks.Find(tiles.Key); chunk != nullptr && *chunk != nullptr)
 			{
 				(*chunk)->SetBlocks(tiles.Value);
+				if(LightEngine != nullptr)
+					LightEngine->AddChunk(tiles.Key);
+				if(FluidSimulation != nullptr)
+					FluidSimulation->ActivateChunk(tiles.Key);
 				if(VisibleChunks.Find(tiles.Key) != nullptr)
 					ChunkMeshesToGenerate.Enqueue(tiles.Key);
 			}
@@ -218,11 +367,34 @@ void AWorldManager::GenerateChunkMeshes()
 	SCOPE_CYCLE_COUNTER(STAT_GenerateChunkMeshes);
 	SCOPED_NAMED_EVENT(AWorldManager_GenerateChunkMeshes, FColor::Blue);
 	TArray<FIntVector> Deferred;
-	while (!ChunkMeshesToGenerate.IsEmpty())
+	TArray<FIntVector> Pending;
 	{
+		TSet<FIntVector> Queued;
 		FIntVector Position;
-		ChunkMeshesToGenerate.Dequeue(Position);
-		const UChunk* const * Chunk = Chunks.Find(Position);
+		while (ChunkMeshesToGenerate.Dequeue(Position))
+		{
+			bool bIsAlreadyQueued = false;
+			Queued.Add(Position, &bIsAlreadyQueued);
+			if(!bIsAlreadyQueued)
+			{
+				Pending.Add(Position);
+			}
+		}
+	}
+	SortByChunkPriority(Pending);
+	const FTickBudget Budget(WorldConfig.ChunkMeshesBudget);
+	int32 Meshed = 0;
+	int32 OverBudget = 0;
+	for (int32 Index = 0; Index < Pending.Num(); ++Index)
+	{
+		const FIntVector& Position = Pending[Index];
+		if(Meshed > 0 && Budget.IsExceeded())
+		{
+			OverBudget = Pending.Num() - Index;
+			Deferred.Append(&Pending[Index], OverBudget);
+			break;
+		}
+		UChunk* const * Chunk = Chunks.Find(Position);
 		if(Chunk == nullptr || *Chunk == nullptr || !VisibleChunks.Find(Position))
 		{
 			continue;
@@ -258,8 +430,14 @@ void AWorldManager::GenerateChunkMeshes()
 			
 			ChunkMeshes.Add(Position, ChunkMesh);
 		}
+		if(WorldConfig.bCaveCulling)
+		{
+			(*Chunk)->UpdateFaceConnectivity();
+		}
 		ChunkMesh->GenerateMesh();
+		Meshed++;
 	}
+	SET_DWORD_STAT(STAT_DeferredChunkMeshes, OverBudget);
 	for (auto chunkPosition : Deferred)
 	{
 		ChunkMeshesToGenerate.Enqueue(chunkPosition);
@@ -270,20 +448,235 @@ void AWorldManager::UnloadChunks()
 {
 	SCOPE_CYCLE_COUNTER(STAT_UnloadChunks);
 	SCOPED_NAMED_EVENT(AWorldManager_UnloadChunks, FColor::Blue);
+	const FTickBudget Budget(WorldConfig.UnloadChunksBudget);
+	TArray<FIntVector> Unloaded;
 	for (auto position : ChunksToUnload)
 	{
+		if(!Unloaded.IsEmpty() && Budget.IsExceeded()) break;
+		Unloaded.Add(position);
+		if(const auto chunk = Chunks.Find(position); chunk != nullptr && *chunk != nullptr && !(*chunk)->bIsReady)
+		{
+			GeneratorRunner->CancelTask(position);
+		}
 		if(const auto chunkMesh = ChunkMeshes.Find(position); chunkMesh != nullptr && *chunkMesh != nullptr)
 		{
 			(*chunkMesh)->Destroy();
 		}
-		if(ModifiedChunks.Find(position) == INDEX_NONE)
+		if(!ModifiedChunks.Contains(position))
 			Chunks.Remove(position);
 		VisibleChunks.Remove(position);
 		ChunkMeshes.Remove(position);
 	}
-	ChunksToUnload.Reset();
+	for (const FIntVector& position : Unloaded)
+	{
+		ChunksToUnload.Remove(position);
+	}
+	SET_DWORD_STAT(STAT_DeferredChunkUnloads, ChunksToUnload.Num());
+}
+
+void AWorldManager::UpdateLighting()
+{
+	if(LightEngine == nullptr) return;
+
+	TSet<FIntVector> ChangedChunks;
+	LightEngine->Propagate(ChangedChunks);
+	for (const FIntVector& changedChunk : ChangedChunks)
+	{
+		// Chunks without a mesh yet are lit by the time they are meshed
+		if(ChunkMeshes.Contains(changedChunk))
+		{
+			ChunkMeshesToGenerate.Enqueue(changedChunk);
+		}
+	}
+}
+
+void AWorldManager::UpdateFluids(const float DeltaTime)
+{
+	if(FluidSimulation == nullptr) return;
+
+	TArray<TPair<FIntVector, FBlock>> BlockChanges;
+	FluidSimulation->Tick(DeltaTime, BlockChanges);
+	if(!BlockChanges.IsEmpty())
+	{
+		ApplyBlockChanges(BlockChanges);
+	}
+}
+
+void AWorldManager::UpdateBlockTicks(const float DeltaTime)
+{
+	if(BlockTickScheduler != nullptr)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_BlockTicks);
+		const int32 Steps = BlockTickScheduler->ConsumeSteps(DeltaTime);
+		TArray<FScheduledBlockTick> DueTicks;
+		TArray<FIntVector> RandomPositions;
+		for (int32 Step = 0; Step < Steps; ++Step)
+		{
+			DueTicks.Reset();
+			BlockTickScheduler->Advance(DueTicks);
+			const UChunk* chunk = nullptr;
+			FIntVector chunkPosition;
+			for (const FScheduledBlockTick& DueTick : DueTicks)
+			{
+				const FBlock Block = GetLoadedBlock(DueTick.Position, chunk, chunkPosition);
+				if(Block == Air || Block.BlockTypeID != DueTick.BlockTypeID || !BlockTickHandlers.IsValidIndex(Block.BlockTypeID)) continue;
+				if(UBlockTickHandler* Handler = BlockTickHandlers[Block.BlockTypeID])
+				{
+					Handler->OnBlockTick(this, DueTick.Position, Block, false);
+				}
+			}
+
+			if(!bHasRandomTicks) continue;
+			RandomPositions.Reset();
+			for (const auto& loadedChunk : Chunks)
+			{
+				if(loadedChunk.Value != nullptr && loadedChunk.Value->bIsReady)
+				{
+					BlockTickScheduler->SampleRandomTicks(loadedChunk.Key, RandomPositions);
+				}
+			}
+			for (const FIntVector& Position : RandomPositions)
+			{
+				const FBlock Block = GetLoadedBlock(Position, chunk, chunkPosition);
+				if(Block == Air || !BlockTickHandlers.IsValidIndex(Block.BlockTypeID) || !WorldConfig.BlockTypes[Block.BlockTypeID].bRandomTicks) continue;
+				if(UBlockTickHandler* Handler = BlockTickHandlers[Block.BlockTypeID])
+				{
+					Handler->OnBlockTick(this, Position, Block, true);
+				}
+			}
+		}
+	}
+
+	if(!QueuedBlockChanges.IsEmpty())
+	{
+		// Handlers may queue changes while they are applied
+		const TArray<TPair<FIntVector, FBlock>> BlockChanges = MoveTemp(QueuedBlockChanges);
+		QueuedBlockChanges.Reset();
+		ApplyBlockChanges(BlockChanges);
+	}
+}
+
+void AWorldManager::ScheduleBlockTick(const FIntVector& InPosition, const int32 InDelay)
+{
+	if(BlockTickScheduler == nullptr) return;
+
+	const FBlock Block = GetBlock(InPosition);
+	if(Block != Air)
+	{
+		BlockTickScheduler->Schedule(InPosition, Block.BlockTypeID, InDelay);
+	}
+}
+
+void AWorldManager::QueueBlockChange(const FIntVector& InPosition, const FBlock& InBlock)
+{
+	QueuedBlockChanges.Emplace(InPosition, InBlock);
+}
+
+void AWorldManager::UpdateChunkMeshSectionVisibility()
+{
+	if(!WorldConfig.bSplitSectionsByDirection) return;
+	SCOPE_CYCLE_COUNTER(STAT_UpdateSectionVisibility);
+
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if(PlayerController == nullptr || PlayerController->PlayerCameraManager == nullptr) return;
+
+	const FVector CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+	for (const auto chunkMesh : ChunkMeshes)
+	{
+		if(chunkMesh.Value != nullptr)
+		{
+			chunkMesh.Value->UpdateSectionVisibility(CameraLocation);
+		}
+	}
+}
+
+void AWorldManager::UpdateChunkMeshOcclusion()
+{
+	if(!WorldConfig.bCaveCulling) return;
+	SCOPE_CYCLE_COUNTER(STAT_UpdateChunkOcclusion);
+
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if(PlayerController == nullptr || PlayerController->PlayerCameraManager == nullptr) return;
+
+	const FVector CameraBlock = WorldToBlockSpace(PlayerController->PlayerCameraManager->GetCameraLocation());
+	const FIntVector CameraChunk = GetChunkPositionFromBlockWorldCoordinates(FIntVector(FMath::FloorToInt(CameraBlock.X), FMath::FloorToInt(CameraBlock.Y), FMath::FloorToInt(CameraBlock.Z)));
+	const int32 MaxDistance = WorldConfig.MaxChunkRenderDistance + 1;
+
+	// Top, Bottom, Front, Back, Right, Left, the opposite face is the index xor 1
+	static const FIntVector Directions[6] = {{0,0,1}, {0,0,-1}, {0,1,0}, {0,-1,0}, {1,0,0}, {-1,0,0}};
+	struct FVisit
+	{
+		FIntVector Position;
+		// Face the chunk was entered through, INDEX_NONE for the camera chunk
+		int32 EnteredFace;
+		// Directions already walked, the search never turns back towards the camera
+		uint8 UsedDirections;
+	};
+
+	TSet<FIntVector> Reached;
+	TArray<FVisit> Queue;
+	Queue.Add({CameraChunk, INDEX_NONE, 0});
+	Reached.Add(CameraChunk);
+	for (int32 Index = 0; Index < Queue.Num(); ++Index)
+	{
+		const FVisit Visit = Queue[Index];
+		// Missing chunks above, below or not loaded yet don't block the view
+		const auto chunk = Chunks.Find(Visit.Position);
+		const UChunk* Chunk = chunk != nullptr && *chunk != nullptr && (*chunk)->bIsReady ? *chunk : nullptr;
+		for (int32 Direction = 0; Direction < 6; ++Direction)
+		{
+			if(Visit.UsedDirections & (1 << (Direction ^ 1))) continue;
+			if(Chunk != nullptr && Visit.EnteredFace != INDEX_NONE && !Chunk->AreFacesConnected(Visit.EnteredFace, Direction)) continue;
+
+			const FIntVector Next = Visit.Position + Directions[Direction];
+			if(Next.Z < -1 || Next.Z > WorldConfig.MaxChunksZ) continue;
+			if(FMath::Abs(Next.X - CameraChunk.X) > MaxDistance || FMath::Abs(Next.Y - CameraChunk.Y) > MaxDistance) continue;
+			if(Reached.Contains(Next)) continue;
+
+			Reached.Add(Next);
+			Queue.Add({Next, Direction ^ 1, static_cast<uint8>(Visit.UsedDirections | (1 << Direction))});
+		}
+	}
+
+	int32 Occluded = 0;
+	for (const auto chunkMesh : ChunkMeshes)
+	{
+		if(chunkMesh.Value == nullptr) continue;
+
+		const bool bIsHidden = !Reached.Contains(chunkMesh.Key);
+		if(chunkMesh.Value->IsHidden() != bIsHidden)
+		{
+			chunkMesh.Value->SetActorHiddenInGame(bIsHidden);
+		}
+		Occluded += bIsHidden;
+	}
+	SET_DWORD_STAT(STAT_OccludedChunkMeshes, Occluded);
 }
 
+void AWorldManager::UpdateChunkMeshCollision()
+{
+	if(!WorldConfig.bUseSimpleCollision) return;
+	SCOPE_CYCLE_COUNTER(STAT_UpdateChunkCollision);
+
+	for (const auto chunkMesh : ChunkMeshes)
+	{
+		if(chunkMesh.Value == nullptr) continue;
+
+		bool bIsInPhysicsRange = false;
+		for (const auto trackable : TrackerComponents)
+		{
+			if(!trackable->bIsTrackable) continue;
+
+			const FIntVector Delta = chunkMesh.Key - trackable->LastWorldPosition;
+			if(FMath::Max3(abs(Delta.X), abs(Delta.Y), abs(Delta.Z)) <= WorldConfig.CollisionChunkDistance)
+			{
+				bIsInPhysicsRange = true;
+				break;
+			}
+		}
+		chunkMesh.Value->SetChunkCollisionEnabled(bIsInPhysicsRange);
+	}
+}
 
 TArray<FBlockType> AWorldManager::GetBlockTypes() const
 {
@@ -345,14 +738,13 @@ void AWorldManager::SetBlock(const FIntVector& InPosition, const FBlock& InBlock
 {
 	const FIntVector chunkPosition = GetChunkPositionFromBlockWorldCoordinates(InPosition);
 	const FIntVector tilePosition = GetBlockPositionFromWorldBlockCoordinates(InPosition);
-	if(ModifiedChunks.Find(chunkPosition) == INDEX_NONE)
-	{
-		ModifiedChunks.Add(chunkPosition);
-	}
+	ModifiedChunks.Add(chunkPosition);
 	
 	if(const auto chunk = Chunks.Find(chunkPosition); chunk != nullptr && *chunk != nullptr)
 	{
+		const FBlock OldBlock = (*chunk)->GetBlocks().GetBlock(tilePosition);
 		(*chunk)->AddBlock(tilePosition, InBlock);
+		OnBlockChanged(InPosition, OldBlock, InBlock);
 		ChunkMeshesToGenerate.Enqueue(chunkPosition);
 		if(tilePosition.X == 0)
 		{
@@ -415,6 +807,7 @@ FBlock AWorldManager::RemoveBlock(const FIntVector& InPosition)
 	if(block != Air)
 	{
 		RemoveBlock(chunkPosition, tilePosition);
+		OnBlockChanged(InPosition, block, Air);
 
 		// Update Neighbors
 		if( tilePosition.X == 0)
@@ -452,11 +845,423 @@ void AWorldManager::RemoveBlock(const FIntVector& InChunkPosition, const FIntVec
 		(*chunk)->RemoveBlock(InBlockPosition);
 		ChunkMeshesToGenerate.Enqueue(InChunkPosition);
 
-		if(ModifiedChunks.Find(InChunkPosition) == INDEX_NONE)
+		ModifiedChunks.Add(InChunkPosition);
+	}
+}
+
+int32 AWorldManager::EditBlocks(const FIntVector& InMin, const FIntVector& InMax, const TFunctionRef<bool(const FIntVector&, FBlock&)> InEdit)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EditBlocks);
+	const FIntVector MinChunk = GetChunkPositionFromBlockWorldCoordinates(InMin);
+	const FIntVector MaxChunk = GetChunkPositionFromBlockWorldCoordinates(InMax);
+
+	int32 ChangedBlocks = 0;
+	TSet<FIntVector> DirtyChunks;
+	for (int ChunkZ = MinChunk.Z; ChunkZ <= MaxChunk.Z; ++ChunkZ)
+	{
+		for (int ChunkY = MinChunk.Y; ChunkY <= MaxChunk.Y; ++ChunkY)
+		{
+			for (int ChunkX = MinChunk.X; ChunkX <= MaxChunk.X; ++ChunkX)
+			{
+				const FIntVector chunkPosition(ChunkX, ChunkY, ChunkZ);
+				const auto chunk = Chunks.Find(chunkPosition);
+				if(chunk == nullptr || *chunk == nullptr || !(*chunk)->bIsReady) continue;
+
+				// Part of the region inside this chunk in local block coordinates
+				const FIntVector ChunkOrigin(ChunkX * WorldConfig.ChunkSize.X, ChunkY * WorldConfig.ChunkSize.Y, ChunkZ * WorldConfig.ChunkSize.Z);
+				const FIntVector LocalMin = FIntVector(	FMath::Max(InMin.X - ChunkOrigin.X, 0),
+														FMath::Max(InMin.Y - ChunkOrigin.Y, 0),
+														FMath::Max(InMin.Z - ChunkOrigin.Z, 0));
+				const FIntVector LocalMax = FIntVector(	FMath::Min(InMax.X - ChunkOrigin.X, WorldConfig.ChunkSize.X-1),
+														FMath::Min(InMax.Y - ChunkOrigin.Y, WorldConfig.ChunkSize.Y-1),
+														FMath::Min(InMax.Z - ChunkOrigin.Z, WorldConfig.ChunkSize.Z-1));
+
+				FIntVector ChangedMin(MAX_int32), ChangedMax(MIN_int32);
+				for (int Z = LocalMin.Z; Z <= LocalMax.Z; ++Z)
+				{
+					for (int Y = LocalMin.Y; Y <= LocalMax.Y; ++Y)
+					{
+						for (int X = LocalMin.X; X <= LocalMax.X; ++X)
+						{
+							const FIntVector LocalPosition(X, Y, Z);
+							const FBlock OldBlock = (*chunk)->GetBlocks().GetBlock(LocalPosition);
+							FBlock NewBlock = OldBlock;
+							if(!InEdit(ChunkOrigin + LocalPosition, NewBlock) || NewBlock == OldBlock) continue;
+
+							(*chunk)->AddBlock(LocalPosition, NewBlock);
+							OnBlockChanged(ChunkOrigin + LocalPosition, OldBlock, NewBlock);
+							ChangedMin = FIntVector(FMath::Min(ChangedMin.X, X), FMath::Min(ChangedMin.Y, Y), FMath::Min(ChangedMin.Z, Z));
+							ChangedMax = FIntVector(FMath::Max(ChangedMax.X, X), FMath::Max(ChangedMax.Y, Y), FMath::Max(ChangedMax.Z, Z));
+							ChangedBlocks++;
+						}
+					}
+				}
+				if(ChangedMin.X == MAX_int32) continue;
+
+				MarkChunkDirty(chunkPosition, ChangedMin, ChangedMax, DirtyChunks);
+			}
+		}
+	}
+
+	EnqueueDirtyChunks(DirtyChunks);
+	return ChangedBlocks;
+}
+
+bool AWorldManager::AddFluid(const FIntVector& InPosition, const FBlock& InFluid, const int32 InLevel)
+{
+	if(FluidSimulation == nullptr || !FluidSimulation->IsFluid(InFluid) || InLevel <= 0) return false;
+
+	const FBlock Block = GetBlock(InPosition);
+	if(Block != Air && Block != InFluid) return false;
+
+	const int32 Level = FMath::Min<int32>((Block == Air ? 0 : FluidSimulation->GetLevel(InPosition)) + InLevel, FFluidSimulation::MaxLevel);
+	if(Block == Air)
+	{
+		SetBlock(InPosition, InFluid);
+	}
+	FluidSimulation->SetLevel(InPosition, Level);
+	FluidSimulation->Activate(InPosition);
+	return true;
+}
+
+int32 AWorldManager::GetFluidLevel(const FIntVector& InPosition) const
+{
+	return FluidSimulation != nullptr ? FluidSimulation->GetLevel(InPosition) : 0;
+}
+
+int32 AWorldManager::ApplyBlockChanges(const TArray<TPair<FIntVector, FBlock>>& InChanges)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EditBlocks);
+	TMap<FIntVector, TArray<int32>> ChangesByChunk;
+	for (int32 Index = 0; Index < InChanges.Num(); ++Index)
+	{
+		ChangesByChunk.FindOrAdd(GetChunkPositionFromBlockWorldCoordinates(InChanges[Index].Key)).Add(Index);
+	}
+
+	int32 ChangedBlocks = 0;
+	TSet<FIntVector> DirtyChunks;
+	for (const auto& chunkChanges : ChangesByChunk)
+	{
+		const auto chunk = Chunks.Find(chunkChanges.Key);
+		if(chunk == nullptr || *chunk == nullptr || !(*chunk)->bIsReady) continue;
+
+		FIntVector ChangedMin(MAX_int32), ChangedMax(MIN_int32);
+		for (const int32 Index : chunkChanges.Value)
+		{
+			const FIntVector LocalPosition = GetBlockPositionFromWorldBlockCoordinates(InChanges[Index].Key);
+			const FBlock OldBlock = (*chunk)->GetBlocks().GetBlock(LocalPosition);
+			const FBlock& NewBlock = InChanges[Index].Value;
+			if(NewBlock == OldBlock) continue;
+
+			(*chunk)->AddBlock(LocalPosition, NewBlock);
+			OnBlockChanged(InChanges[Index].Key, OldBlock, NewBlock);
+			ChangedMin = FIntVector(FMath::Min(ChangedMin.X, LocalPosition.X), FMath::Min(ChangedMin.Y, LocalPosition.Y), FMath::Min(ChangedMin.Z, LocalPosition.Z));
+			ChangedMax = FIntVector(FMath::Max(ChangedMax.X, LocalPosition.X), FMath::Max(ChangedMax.Y, LocalPosition.Y), FMath::Max(ChangedMax.Z, LocalPosition.Z));
+			ChangedBlocks++;
+		}
+		if(ChangedMin.X == MAX_int32) continue;
+
+		MarkChunkDirty(chunkChanges.Key, ChangedMin, ChangedMax, DirtyChunks);
+	}
+
+	EnqueueDirtyChunks(DirtyChunks);
+	return ChangedBlocks;
+}
+
+void AWorldManager::MarkChunkDirty(const FIntVector& InChunkPosition, const FIntVector& InChangedMin, const FIntVector& InChangedMax, TSet<FIntVector>& OutDirtyChunks)
+{
+	ModifiedChunks.Add(InChunkPosition);
+	OutDirtyChunks.Add(InChunkPosition);
+	// Neighbors only need a new mesh if a border block changed
+	if(InChangedMin.X == 0) OutDirtyChunks.Add(InChunkPosition+FIntVector(-1,0,0));
+	if(InChangedMin.Y == 0) OutDirtyChunks.Add(InChunkPosition+FIntVector(0,-1,0));
+	if(InChangedMin.Z == 0) OutDirtyChunks.Add(InChunkPosition+FIntVector(0,0,-1));
+	if(InChangedMax.X == WorldConfig.ChunkSize.X-1) OutDirtyChunks.Add(InChunkPosition+FIntVector(1,0,0));
+	if(InChangedMax.Y == WorldConfig.ChunkSize.Y-1) OutDirtyChunks.Add(InChunkPosition+FIntVector(0,1,0));
+	if(InChangedMax.Z == WorldConfig.ChunkSize.Z-1) OutDirtyChunks.Add(InChunkPosition+FIntVector(0,0,1));
+}
+
+void AWorldManager::EnqueueDirtyChunks(const TSet<FIntVector>& InDirtyChunks)
+{
+	for (const FIntVector& dirtyChunk : InDirtyChunks)
+	{
+		if(Chunks.Contains(dirtyChunk))
+		{
+			ChunkMeshesToGenerate.Enqueue(dirtyChunk);
+		}
+	}
+}
+
+void AWorldManager::OnBlockChanged(const FIntVector& InPosition, const FBlock& InOldBlock, const FBlock& InNewBlock)
+{
+	if(LightEngine != nullptr)
+	{
+		LightEngine->UpdateBlock(InPosition, InOldBlock, InNewBlock);
+	}
+	if(FluidSimulation != nullptr)
+	{
+		FluidSimulation->UpdateBlock(InPosition, InOldBlock, InNewBlock);
+	}
+}
+
+int32 AWorldManager::FillBlocks(const FIntVector& InMin, const FIntVector& InMax, const FBlock& InBlock)
+{
+	return EditBlocks(InMin, InMax, [&](const FIntVector&, FBlock& Block)
+	{
+		Block = InBlock;
+		return true;
+	});
+}
+
+int32 AWorldManager::FillSphere(const FIntVector& InCenter, const float InRadius, const FBlock& InBlock)
+{
+	const int32 Extent = FMath::CeilToInt(InRadius);
+	const float RadiusSquared = InRadius * InRadius;
+	return EditBlocks(InCenter - FIntVector(Extent), InCenter + FIntVector(Extent), [&](const FIntVector& Position, FBlock& Block)
+	{
+		const FIntVector Delta = Position - InCenter;
+		if(Delta.X*Delta.X + Delta.Y*Delta.Y + Delta.Z*Delta.Z > RadiusSquared) return false;
+		Block = InBlock;
+		return true;
+	});
+}
+
+int32 AWorldManager::ReplaceBlocks(const FIntVector& InMin, const FIntVector& InMax, const FBlock& InFrom, const FBlock& InTo)
+{
+	return EditBlocks(InMin, InMax, [&](const FIntVector&, FBlock& Block)
+	{
+		if(Block != InFrom) return false;
+		Block = InTo;
+		return true;
+	});
+}
+
+int32 AWorldManager::PasteBlocks(const FIntVector& InOrigin, const FIntVector& InSize, const TArray<FBlock>& InBlocks, const bool bSkipAir)
+{
+	if(InSize.X <= 0 || InSize.Y <= 0 || InSize.Z <= 0 || InBlocks.Num() < InSize.X * InSize.Y * InSize.Z) return 0;
+
+	// Same layout as TChunkData, X first then Y then Z
+	return EditBlocks(InOrigin, InOrigin + InSize - FIntVector(1), [&](const FIntVector& Position, FBlock& Block)
+	{
+		const FIntVector Local = Position - InOrigin;
+		const FBlock& Pasted = InBlocks[Local.Z * InSize.X * InSize.Y + Local.Y * InSize.X + Local.X];
+		if(bSkipAir && Pasted == Air) return false;
+		Block = Pasted;
+		return true;
+	});
+}
+
+FVector AWorldManager::WorldToBlockSpace(const FVector& InLocation) const
+{
+	return (InLocation + WorldConfig.GetChunkWorldSize()/2*FVector(1.0f, 1.0f, 0.0f)) / WorldConfig.BlockSize;
+}
+
+FVector AWorldManager::BlockSpaceToWorld(const FVector& InBlockSpaceLocation) const
+{
+	return InBlockSpaceLocation * WorldConfig.BlockSize - WorldConfig.GetChunkWorldSize()/2*FVector(1.0f, 1.0f, 0.0f);
+}
+
+FBlock AWorldManager::GetLoadedBlock(const FIntVector& InPosition, const UChunk*& InOutChunk, FIntVector& InOutChunkPosition) const
+{
+	const FIntVector chunkPosition = GetChunkPositionFromBlockWorldCoordinates(InPosition);
+	if(InOutChunk == nullptr || chunkPosition != InOutChunkPosition)
+	{
+		const auto chunk = Chunks.Find(chunkPosition);
+		InOutChunk = chunk != nullptr ? *chunk : nullptr;
+		InOutChunkPosition = chunkPosition;
+	}
+	if(InOutChunk == nullptr || !InOutChunk->bIsReady) return Air;
+
+	return InOutChunk->GetBlocks().GetBlock(GetBlockPositionFromWorldBlockCoordinates(InPosition));
+}
+
+bool AWorldManager::IsBlockSolid(const FIntVector& InPosition, const UChunk*& InOutChunk, FIntVector& InOutChunkPosition) const
+{
+	const FBlock block = GetLoadedBlock(InPosition, InOutChunk, InOutChunkPosition);
+	return block != Air && WorldConfig.BlockTypes.IsValidIndex(block.BlockTypeID) && WorldConfig.BlockTypes[block.BlockTypeID].bIsSolid;
+}
+
+bool AWorldManager::IsBlockSolid(const FIntVector& InPosition) const
+{
+	const UChunk* chunk = nullptr;
+	FIntVector chunkPosition;
+	return IsBlockSolid(InPosition, chunk, chunkPosition);
+}
+
+bool AWorldManager::OverlapBlocks(const FBox& InBox) const
+{
+	const FVector Min = WorldToBlockSpace(InBox.Min);
+	const FVector Max = WorldToBlockSpace(InBox.Max);
+	const FIntVector Start(floor(Min.X), floor(Min.Y), floor(Min.Z));
+	const FIntVector End(ceil(Max.X)-1, ceil(Max.Y)-1, ceil(Max.Z)-1);
+
+	const UChunk* chunk = nullptr;
+	FIntVector chunkPosition;
+	for (int Z = Start.Z; Z <= End.Z; ++Z)
+	{
+		for (int Y = Start.Y; Y <= End.Y; ++Y)
+		{
+			for (int X = Start.X; X <= End.X; ++X)
+			{
+				if(IsBlockSolid({X, Y, Z}, chunk, chunkPosition))
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+bool AWorldManager::SweepBlocks(const FBox& InBox, const FVector& InDelta, FBlockHitResult& OutHit) const
+{
+	OutHit = FBlockHitResult();
+	const FVector Min = WorldToBlockSpace(InBox.Min);
+	const FVector Max = WorldToBlockSpace(InBox.Max);
+	const FVector Delta = InDelta / WorldConfig.BlockSize;
+
+	// Sweep in steps of at most one block so the first hit is found without testing the whole swept volume
+	const int32 Steps = FMath::Max(1, FMath::CeilToInt(Delta.GetAbsMax()));
+	const UChunk* chunk = nullptr;
+	FIntVector chunkPosition;
+	for (int32 Step = 0; Step < Steps && !OutHit.bBlockingHit; ++Step)
+	{
+		const float StepStart = static_cast<float>(Step) / Steps;
+		const float StepEnd = static_cast<float>(Step + 1) / Steps;
+		const FVector BroadMin = FVector::Min(Min + Delta*StepStart, Min + Delta*StepEnd);
+		const FVector BroadMax = FVector::Max(Max + Delta*StepStart, Max + Delta*StepEnd);
+		const FIntVector Start(floor(BroadMin.X), floor(BroadMin.Y), floor(BroadMin.Z));
+		const FIntVector End(ceil(BroadMax.X)-1, ceil(BroadMax.Y)-1, ceil(BroadMax.Z)-1);
+
+		float BestTime = StepEnd;
+		for (int Z = Start.Z; Z <= End.Z; ++Z)
+		{
+			for (int Y = Start.Y; Y <= End.Y; ++Y)
+			{
+				for (int X = Start.X; X <= End.X; ++X)
+				{
+					const FIntVector BlockPosition(X, Y, Z);
+					if(!IsBlockSolid(BlockPosition, chunk, chunkPosition)) continue;
+
+					// Slab test of the moving box against the unit block
+					float EnterTime = -MAX_flt;
+					float ExitTime = MAX_flt;
+					int32 EnterAxis = INDEX_NONE;
+					for (int32 Axis = 0; Axis < 3; ++Axis)
+					{
+						const float BlockMin = BlockPosition[Axis];
+						const float BlockMax = BlockPosition[Axis] + 1;
+						if(Delta[Axis] == 0.0f)
+						{
+							if(Max[Axis] <= BlockMin || Min[Axis] >= BlockMax)
+							{
+								EnterTime = MAX_flt;
+								break;
+							}
+							continue;
+						}
+						const float AxisEnter = (Delta[Axis] > 0.0f ? BlockMin - Max[Axis] : BlockMax - Min[Axis]) / Delta[Axis];
+						const float AxisExit = (Delta[Axis] > 0.0f ? BlockMax - Min[Axis] : BlockMin - Max[Axis]) / Delta[Axis];
+						if(AxisEnter > EnterTime)
+						{
+							EnterTime = AxisEnter;
+							EnterAxis = Axis;
+						}
+						ExitTime = FMath::Min(ExitTime, AxisExit);
+					}
+					if(EnterTime >= ExitTime || EnterTime > BestTime || ExitTime <= 0.0f) continue;
+
+					BestTime = FMath::Max(EnterTime, 0.0f);
+					OutHit.bBlockingHit = true;
+					OutHit.bStartPenetrating = EnterTime < 0.0f || EnterAxis == INDEX_NONE;
+					OutHit.Time = BestTime;
+					OutHit.BlockPosition = BlockPosition;
+					OutHit.Normal = FVector::ZeroVector;
+					if(!OutHit.bStartPenetrating)
+					{
+						OutHit.Normal[EnterAxis] = Delta[EnterAxis] > 0.0f ? -1.0f : 1.0f;
+					}
+				}
+			}
+		}
+	}
+	OutHit.Location = InBox.GetCenter() + InDelta * OutHit.Time;
+	return OutHit.bBlockingHit;
+}
+
+bool AWorldManager::LineTraceBlocks(const FVector& InStart, const FVector& InEnd, FBlockHitResult& OutHit) const
+{
+	return TraceBlocks(InStart, InEnd, true, OutHit);
+}
+
+bool AWorldManager::RaycastBlocks(const FVector& InOrigin, const FVector& InDirection, const float InMaxDistance, FBlockHitResult& OutHit) const
+{
+	return TraceBlocks(InOrigin, InOrigin + InDirection.GetSafeNormal() * InMaxDistance, false, OutHit);
+}
+
+bool AWorldManager::TraceBlocks(const FVector& InStart, const FVector& InEnd, const bool bOnlySolid, FBlockHitResult& OutHit) const
+{
+	OutHit = FBlockHitResult();
+	const FVector Start = WorldToBlockSpace(InStart);
+	const FVector Delta = WorldToBlockSpace(InEnd) - Start;
+
+	const UChunk* chunk = nullptr;
+	FIntVector chunkPosition;
+	auto IsHit = [&](const FIntVector& InPosition, FBlock& OutBlock)
+	{
+		OutBlock = GetLoadedBlock(InPosition, chunk, chunkPosition);
+		if(OutBlock == Air || !WorldConfig.BlockTypes.IsValidIndex(OutBlock.BlockTypeID)) return false;
+		return !bOnlySolid || WorldConfig.BlockTypes[OutBlock.BlockTypeID].bIsSolid;
+	};
+
+	FIntVector Block(floor(Start.X), floor(Start.Y), floor(Start.Z));
+	if(IsHit(Block, OutHit.Block))
+	{
+		OutHit.bBlockingHit = true;
+		OutHit.bStartPenetrating = true;
+		OutHit.Time = 0.0f;
+		OutHit.Location = InStart;
+		OutHit.BlockPosition = Block;
+		OutHit.PreviousBlockPosition = Block;
+		return true;
+	}
+
+	// Amanatides & Woo voxel traversal
+	FIntVector Step;
+	FVector NextBoundary, BoundaryStep;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		Step[Axis] = Delta[Axis] > 0.0f ? 1 : (Delta[Axis] < 0.0f ? -1 : 0);
+		BoundaryStep[Axis] = Step[Axis] != 0 ? 1.0f / FMath::Abs(Delta[Axis]) : MAX_flt;
+		NextBoundary[Axis] = Step[Axis] > 0 ? (Block[Axis] + 1 - Start[Axis]) * BoundaryStep[Axis] :
+							 Step[Axis] < 0 ? (Start[Axis] - Block[Axis]) * BoundaryStep[Axis] : MAX_flt;
+	}
+
+	while (true)
+	{
+		const int32 Axis = NextBoundary.X < NextBoundary.Y ? (NextBoundary.X < NextBoundary.Z ? 0 : 2) : (NextBoundary.Y < NextBoundary.Z ? 1 : 2);
+		const float Time = NextBoundary[Axis];
+		if(Time > 1.0f) break;
+
+		const FIntVector PreviousBlock = Block;
+		Block[Axis] += Step[Axis];
+		NextBoundary[Axis] += BoundaryStep[Axis];
+		if(IsHit(Block, OutHit.Block))
 		{
-			ModifiedChunks.Add(InChunkPosition);
+			OutHit.bBlockingHit = true;
+			OutHit.Time = Time;
+			OutHit.Location = BlockSpaceToWorld(Start + Delta * Time);
+			OutHit.Normal[Axis] = -Step[Axis];
+			OutHit.BlockPosition = Block;
+			OutHit.PreviousBlockPosition = PreviousBlock;
+			return true;
 		}
 	}
+	OutHit.Block = Air;
+	OutHit.Location = InEnd;
+	OutHit.BlockPosition = Block;
+	OutHit.PreviousBlockPosition = Block;
+	return false;
 }
 
 bool AWorldManager::SaveWorld()
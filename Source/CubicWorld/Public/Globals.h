@@ -1,3 +1,26 @@
 ﻿#pragma once
 
-DECLARE_STATS_GROUP(TEXT("Cubic_World"), STATGROUP_CubicWorld, STATCAT_Advanced);
\ No newline at end of file
+DECLARE_STATS_GROUP(TEXT("Cubic_World"), STATGROUP_CubicWorld, STATCAT_Advanced);
+
+// Rounds towards negative infinity, for a positive B like chunk sizes
+inline int32 FloorDivide(const int32 A, const int32 B)
+{
+	return A >= 0 ? A / B : (A - B + 1) / B;
+}
+
+// Time left for one stage of a tick, a budget of 0 is unlimited
+struct FTickBudget
+{
+	explicit FTickBudget(const float InMilliseconds) :
+		EndTime(InMilliseconds > 0.0f ? FPlatformTime::Seconds() + InMilliseconds / 1000.0 : MAX_dbl)
+	{
+	}
+
+	bool IsExceeded() const
+	{
+		return FPlatformTime::Seconds() >= EndTime;
+	}
+
+private:
+	double EndTime;
+};
\ No newline at end of file
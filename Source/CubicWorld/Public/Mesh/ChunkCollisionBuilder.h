@@ -0,0 +1,23 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "World/ChunkData.h"
+#include "World/Structs/WorldConfig.h"
+
+/**
+ * Merges the solid blocks of a chunk into as few boxes as possible for simple collision
+ */
+class CUBICWORLD_API FChunkCollisionBuilder
+{
+public:
+	struct FCollisionBox
+	{
+		FIntVector Min;
+		FIntVector Max;
+	};
+
+	static bool IsSolid(const FBlock& InBlock, const FWorldConfig& InWorldConfig);
+	static void BuildBoxes(const TChunkData& InBlocks, const FWorldConfig& InWorldConfig, TArray<FCollisionBox>& OutBoxes);
+};
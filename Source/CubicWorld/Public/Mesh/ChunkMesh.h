@@ -37,6 +37,9 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void GenerateMesh();
 
+	void UpdateSectionVisibility(const FVector& InViewLocation) const;
+	void SetChunkCollisionEnabled(bool bInCollisionEnabled) const;
+
 	UFUNCTION(BlueprintCallable)
 	void ShowDebugLines(bool ChunkDebugLines = false, bool BlocksDebugLines = false, bool GridDebugLines = false) const;
 };
@@ -9,57 +9,10 @@
 #include "RuntimeMeshProviderChunk.generated.h"
 
 struct FBlockConfig;
-struct FSides;
-
-/**
- *
- */
-UCLASS()
-class CUBICWORLD_API URuntimeMeshProviderChunk final : public URuntimeMeshProvider
+namespace VoxelCore
 {
-	GENERATED_BODY()
-
-private:
-	mutable FCriticalSection PropertySyncRoot;
-
-	UPROPERTY(BlueprintGetter = GetChunk, BlueprintSetter = SetChunk)
-	const UChunk *Chunk;
-	
-	UPROPERTY()
-	TArray<FVector> BlockVertices;
-
-public:
-	UFUNCTION(Category = "RuntimeMesh|Providers|Box", BlueprintCallable)
-	const UChunk *GetChunk() const;
-
-	UFUNCTION(Category = "RuntimeMesh|Providers|Box", BlueprintCallable)
-	void SetChunk(const UChunk *InChunk);
-
-	bool bMarkedForDestroy = false;
-
-private:
-	static uint32 AddVertex(FRuntimeMeshRenderableMeshData& MeshData,
-					const FVector& InPosition,
-					const FVector& InNormal, const FVector& InTangent,
-					const FVector2f& UV1, const FVector2f& UV2, const FColor& InColor = FColor::White);
-	static void AddQuad(FRuntimeMeshRenderableMeshData &MeshData,
-					const FVector& Vertex1, const FVector& Vertex2, const FVector& Vertex3, const FVector& Vertex4,
-					const FVector& Normal, const FVector& Tangent,
-					const uint32 TextureId,	const FVector2f& UVMultiplication, const FColor& Color);
-	void GreedyMesh(FRuntimeMeshRenderableMeshData& MeshData);
-	
-	FSides GetSidesToRender(FIntVector InPosition) const;
-
-protected:
-	virtual void Initialize() override;
-	virtual FBoxSphereBounds GetBounds() override;
-	virtual bool GetSectionMeshForLOD(int32 LODIndex, int32 SectionId, FRuntimeMeshRenderableMeshData &MeshData) override;
-	virtual FRuntimeMeshCollisionSettings GetCollisionSettings() override;
-	virtual bool HasCollisionMesh() override;
-	virtual bool GetCollisionMesh(FRuntimeMeshCollisionData &CollisionData) override;
-	virtual bool IsThreadSafe() override;
-};
-
+	struct FSideMesh;
+}
 
 struct FSides
 {
@@ -75,6 +28,8 @@ struct FSides
 		Left	= Top << 5
 	};
 
+	static constexpr int32 Num = 6;
+
 	FSides(){}
 	explicit FSides(const bool InSides): Sides(InSides)
 	{
@@ -91,6 +46,31 @@ struct FSides
 		Sides = InTop | InBottom | InFront | InBack | InRight | InLeft;
 	}
 
+	static int32 GetSideIndex(const ESide InSide)
+	{
+		return FMath::CountTrailingZeros(static_cast<uint32>(InSide));
+	}
+
+	static ESide GetSide(const int32 InSideIndex)
+	{
+		return static_cast<ESide>(1 << InSideIndex);
+	}
+
+	// Offset to the block the side is facing
+	static FIntVector GetSideOffset(const ESide InSide)
+	{
+		switch (InSide)
+		{
+			case Top:		return FIntVector(0, 0, 1);
+			case Bottom:	return FIntVector(0, 0, -1);
+			case Front:		return FIntVector(0, 1, 0);
+			case Back:		return FIntVector(0, -1, 0);
+			case Right:		return FIntVector(1, 0, 0);
+			case Left:		return FIntVector(-1, 0, 0);
+		}
+		return FIntVector(0);
+	}
+
 	bool HasSide(const ESide InSide) const
 	{
 		return InSide == (InSide & Sides);
@@ -111,13 +91,82 @@ struct FSides
 	{
 		return Sides && InSide;
 	}
-	
+
 	bool operator==(const FSides& rhs) const
 	{
 		return Sides && rhs.Sides;
 	}
 };
 
+/**
+ *
+ */
+UCLASS()
+class CUBICWORLD_API URuntimeMeshProviderChunk final : public URuntimeMeshProvider
+{
+	GENERATED_BODY()
+
+private:
+	mutable FCriticalSection PropertySyncRoot;
+
+	UPROPERTY(BlueprintGetter = GetChunk, BlueprintSetter = SetChunk)
+	const UChunk *Chunk;
+
+	// One section per face direction instead of a single section 0
+	bool bSplitSectionsByDirection = false;
+	FSides VisibleSides = FSides(true);
+
+	// All six direction sections are meshed in one pass, the others are kept until requested
+	int32 MeshRevision = 0;
+	int32 CachedMeshRevision = INDEX_NONE;
+	TArray<FRuntimeMeshRenderableMeshData> CachedSideMeshData;
+	TArray<bool> PendingSideMeshData;
+
+	// Merged boxes instead of the render mesh as collision, only built while enabled
+	bool bUseSimpleCollision = false;
+	bool bCollisionEnabled = false;
+
+public:
+	UFUNCTION(Category = "RuntimeMesh|Providers|Box", BlueprintCallable)
+	const UChunk *GetChunk() const;
+
+	UFUNCTION(Category = "RuntimeMesh|Providers|Box", BlueprintCallable)
+	void SetChunk(const UChunk *InChunk);
+
+	bool bMarkedForDestroy = false;
+
+	int32 GetSectionCount() const;
+	void MarkMeshDirty();
+	void UpdateSideVisibility(const FVector& InViewLocation);
+	void SetCollisionEnabled(bool bInCollisionEnabled);
+	// All faces in one mesh, also works without a runtime mesh for tools and tests
+	void GetMeshData(FRuntimeMeshRenderableMeshData& OutMeshData);
+
+private:
+	static uint32 AddVertex(FRuntimeMeshRenderableMeshData& MeshData,
+					const FVector& InPosition,
+					const FVector& InNormal, const FVector& InTangent,
+					const FVector2f& UV1, const FVector2f& UV2, const FColor& InColor = FColor::White);
+	// Quad InQuadIndex of the mesher output, scaled to world units and moved by InOffset
+	static void AddQuad(FRuntimeMeshRenderableMeshData &MeshData, const VoxelCore::FSideMesh& InSideMesh, int32 InQuadIndex,
+					const FVector& InBlockSize, const FVector& InOffset,
+					const FVector& Normal, const FVector& Tangent,
+					const uint32 TextureId,	const FVector2f& UVMultiplication, const FColor& Color,
+					const float AmbientOcclusionStrength = 0.0f);
+	// Runs the engine independent greedy mesher on the chunk, the neighbors are only read for its border
+	void GreedyMesh(const TArray<FRuntimeMeshRenderableMeshData*>& SideMeshData);
+	static FColor ShadeColor(const FColor& InColor, uint8 InLight, const FWorldConfig& InWorldConfig);
+
+protected:
+	virtual void Initialize() override;
+	virtual FBoxSphereBounds GetBounds() override;
+	virtual bool GetSectionMeshForLOD(int32 LODIndex, int32 SectionId, FRuntimeMeshRenderableMeshData &MeshData) override;
+	virtual FRuntimeMeshCollisionSettings GetCollisionSettings() override;
+	virtual bool HasCollisionMesh() override;
+	virtual bool GetCollisionMesh(FRuntimeMeshCollisionData &CollisionData) override;
+	virtual bool IsThreadSafe() override;
+};
+
 struct FBlockConfig
 {
 	FIntVector Position;
@@ -126,4 +175,4 @@ struct FBlockConfig
 	FBlock Tile;
 
 	FBlockConfig(FSides& InNeighbors, const FBlock& InTile, const FIntVector& InPosition, const FVector& InSize) : Position(InPosition), SidesToRender{InNeighbors}, Size(InSize), Tile(InTile) {};
-};
\ No newline at end of file
+};
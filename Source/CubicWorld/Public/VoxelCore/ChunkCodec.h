@@ -0,0 +1,60 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Engine independent, only the standard library may be used here
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VoxelCore
+{
+	struct FRunBlock
+	{
+		uint8_t BlockTypeId = UINT8_MAX;
+		bool bIsVisible = false;
+
+		bool operator==(const FRunBlock& Other) const
+		{
+			return BlockTypeId == Other.BlockTypeId && bIsVisible == Other.bIsVisible;
+		}
+
+		bool operator!=(const FRunBlock& Other) const
+		{
+			return !(*this == Other);
+		}
+	};
+
+	struct FBlockRun
+	{
+		uint32_t Count = 0;
+		FRunBlock Block;
+	};
+
+	/**
+	 * Run length encoded chunk files, byte compatible with what FArchive wrote before:
+	 * the chunk size as three int32, then per run a uint32 count, the uint8 block type and the visibility as uint32.
+	 * Everything is little endian.
+	 */
+	class FChunkEncoder
+	{
+	public:
+		FChunkEncoder(int32_t InSizeX, int32_t InSizeY, int32_t InSizeZ);
+
+		// Blocks in chunk data order
+		void Add(const FRunBlock& InBlock);
+		// Writes the last run, the encoder is empty afterwards
+		std::vector<uint8_t> Finish();
+
+	private:
+		std::vector<uint8_t> Data;
+		FBlockRun Run;
+
+		void WriteRun();
+	};
+
+	// False unless every size is positive and the runs cover exactly the blocks of the chunk,
+	// so a file cut off at a run boundary is rejected too. OutRuns is only complete on success
+	bool DecodeChunk(const uint8_t* InData, size_t InNum, int32_t OutSize[3], std::vector<FBlockRun>& OutRuns);
+}
@@ -0,0 +1,74 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Engine independent, only the standard library may be used here
+
+#include "VoxelCore/ChunkCodec.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace VoxelCore
+{
+	// Same order as FSides in the engine adapter
+	enum class EMeshSide : uint8_t
+	{
+		Top,
+		Bottom,
+		Front,
+		Back,
+		Right,
+		Left
+	};
+	constexpr int32_t MeshSideCount = 6;
+
+	/**
+	 * A chunk as the greedy mesher sees it. Blocks and light are plain arrays in chunk data order, X first and Z last.
+	 * GetBorder is only asked for the cells up to one block outside of the chunk, edges and corners included.
+	 */
+	struct FMesherInput
+	{
+		int32_t Size[3] = {0, 0, 0};
+		const FRunBlock* Blocks = nullptr;
+		// Sky light in the high and block light in the low nibble, null gives every face light 0
+		const uint8_t* Light = nullptr;
+		std::function<void(int32_t X, int32_t Y, int32_t Z, FRunBlock& OutBlock, uint8_t& OutLight)> GetBorder;
+		// Block types from this one up have no mesh, they still hide the faces next to them
+		uint32_t BlockTypeCount = 0;
+		bool bAmbientOcclusion = false;
+	};
+
+	struct FMeshQuad
+	{
+		// First and last block the quad covers
+		int32_t Min[3] = {0, 0, 0};
+		int32_t Max[3] = {0, 0, 0};
+		EMeshSide Side = EMeshSide::Top;
+		FRunBlock Block;
+		// Light of the air in front of the face
+		uint8_t Light = 0;
+		// Two bits per corner, 3 is not occluded
+		uint8_t AmbientOcclusion = 0xFF;
+	};
+
+	// Quads of one side in block units from the chunk origin, four vertices per quad
+	struct FSideMesh
+	{
+		std::vector<FMeshQuad> Quads;
+		// Three floats per vertex
+		std::vector<float> Positions;
+		// Occlusion of each vertex from 0 to 3
+		std::vector<uint8_t> VertexOcclusion;
+		// Two triangles per quad, split along the brighter diagonal
+		std::vector<uint32_t> Indices;
+
+		void Reset();
+	};
+
+	/**
+	 * Merges the visible faces of each side into rectangles of the same block, light and ambient occlusion.
+	 * A face is visible if the block in front of it is air. OutMeshes are indexed by EMeshSide.
+	 */
+	void GreedyMesh(const FMesherInput& InInput, FSideMesh OutMeshes[MeshSideCount]);
+}
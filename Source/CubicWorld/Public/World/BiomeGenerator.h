@@ -0,0 +1,89 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FastNoiseLite.h"
+#include "Generator.h"
+#include "SimpleGenerator.h"
+#include "BiomeGenerator.generated.h"
+
+USTRUCT(BlueprintType)
+struct FBiome
+{
+	GENERATED_BODY()
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FName Name;
+	// Climate the biome is picked for, in the -1 to 1 range of the climate noise
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta=(UIMin = -1.0, UIMax = 1.0))
+	float Temperature = 0;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta=(UIMin = -1.0, UIMax = 1.0))
+	float Humidity = 0;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FNoiseConfig NoiseConfig;
+	// Fractions of the world height the height noise is mapped between
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta=(UIMin = 0.0, UIMax = 1.0))
+	float MinHeight = 0.3f;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta=(UIMin = 0.0, UIMax = 1.0))
+	float MaxHeight = 0.6f;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<FBlockLayer> Layers;
+};
+
+/**
+ * Height map terrain with biomes picked by temperature and humidity noise.
+ * Climate and blended heights are only computed every SampleSpacing blocks, cached per region and interpolated for the columns.
+ */
+UCLASS(BlueprintType, Blueprintable)
+class CUBICWORLD_API UBiomeGenerator final : public UGenerator
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FNoiseConfig TemperatureNoiseConfig;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FNoiseConfig HumidityNoiseConfig;
+	// Biomes further from the climate than the closest one by this much are not blended in
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin = 0.01, UIMax = 1.0))
+	float BlendDistance = 0.3f;
+	// Blocks between two climate and height samples
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin = 1, UIMax = 16))
+	int32 SampleSpacing = 8;
+	// Width of a cached region in blocks, rounded down to the sample spacing
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin = 1))
+	int32 RegionSize = 64;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FBiome> Biomes;
+
+private:
+	// Samples of one region including the ones on its far border
+	struct FBiomeRegion
+	{
+		int32 SamplesPerSide = 0;
+		// Blended surface height in blocks
+		TArray<float> Heights;
+		// Blend weight of every biome at every sample, [Sample * Biomes.Num() + Biome]
+		TArray<float> Weights;
+	};
+	using FBiomeRegionPtr = TSharedPtr<const FBiomeRegion, ESPMode::ThreadSafe>;
+
+	FastNoiseLite TemperatureNoise;
+	FastNoiseLite HumidityNoise;
+	TArray<FastNoiseLite> BiomeNoises;
+	bool bHasBeenInitialized = false;
+
+	// Chunks above each other use the same region, chunks are generated in parallel
+	TMap<FIntPoint, FBiomeRegionPtr> Regions;
+	FCriticalSection RegionsSyncRoot;
+
+	int32 GetRegionBlocks() const;
+	FBiomeRegionPtr GetRegion(const FIntPoint& InRegionPosition, float InMaxHeight);
+	FBiomeRegionPtr BuildRegion(const FIntPoint& InRegionPosition, float InMaxHeight);
+
+public:
+	UBiomeGenerator();
+
+	virtual void Init() override;
+
+	virtual void GenerateChunk(const FChunkConfig& ChunkConfig, TChunkData& Blocks) override;
+};
@@ -0,0 +1,22 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Structs/Block.h"
+#include "UObject/Object.h"
+#include "BlockTickHandler.generated.h"
+
+class AWorldManager;
+
+/**
+ * Behaviour of a block type over time, edits go through AWorldManager::QueueBlockChange
+ */
+UCLASS(Blueprintable, BlueprintType)
+class CUBICWORLD_API UBlockTickHandler : public UObject
+{
+	GENERATED_BODY()
+public:
+	UFUNCTION(BlueprintNativeEvent, Category = "CubicWorld|Tick")
+	void OnBlockTick(AWorldManager* InWorldManager, const FIntVector& InPosition, const FBlock& InBlock, bool bIsRandomTick);
+};
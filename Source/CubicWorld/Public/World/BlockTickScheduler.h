@@ -0,0 +1,57 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Structs/WorldConfig.h"
+
+struct FScheduledBlockTick
+{
+	FIntVector Position;
+	uint8 BlockTypeID;
+	uint64 Tick;
+};
+
+/**
+ * Time wheel of scheduled block ticks and the random tick sampler
+ */
+class CUBICWORLD_API FBlockTickScheduler
+{
+public:
+	static constexpr int32 WheelSize = 256;
+	static constexpr int32 MaxStepsPerUpdate = 4;
+
+	explicit FBlockTickScheduler(const FWorldConfig& InWorldConfig);
+
+	// Keeps the earlier tick if the position is already scheduled
+	void Schedule(const FIntVector& InPosition, uint8 InBlockTypeID, int32 InDelay);
+	bool IsScheduled(const FIntVector& InPosition) const;
+
+	// Number of block ticks due after DeltaTime
+	int32 ConsumeSteps(float InDeltaTime);
+	// Advances one block tick and returns the scheduled ticks that are due
+	void Advance(TArray<FScheduledBlockTick>& OutDueTicks);
+	void SampleRandomTicks(const FIntVector& InChunkPosition, TArray<FIntVector>& OutPositions);
+
+	uint64 GetCurrentTick() const
+	{
+		return CurrentTick;
+	}
+
+	int32 GetScheduledCount() const
+	{
+		return Scheduled.Num();
+	}
+
+private:
+	FWorldConfig WorldConfig;
+	FRandomStream RandomStream;
+
+	TArray<FScheduledBlockTick> Wheel[WheelSize];
+	// Ticks further out than the wheel, a heap ordered by tick
+	TArray<FScheduledBlockTick> Overflow;
+	TMap<FIntVector, uint64> Scheduled;
+
+	uint64 CurrentTick = 0;
+	float Accumulator = 0.0f;
+};
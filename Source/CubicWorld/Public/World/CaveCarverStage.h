@@ -0,0 +1,38 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FastNoiseLite.h"
+#include "GeneratorStage.h"
+#include "SimpleGenerator.h"
+#include "CaveCarverStage.generated.h"
+
+/**
+ * Carves tunnels where two 3D noise fields are both close to 0
+ */
+UCLASS(BlueprintType)
+class CUBICWORLD_API UCaveCarverStage final : public UGeneratorStage
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	FNoiseConfig CaveNoiseConfig;
+	// Distance from 0 both noise fields need to be under, wider tunnels for higher values
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ClampMin = 0.0, UIMax = 0.5))
+	float TunnelWidth = 0.08f;
+	// Fraction of the world height above which nothing is carved
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(UIMin = 0.0, UIMax = 1.0))
+	float MaxHeight = 0.6f;
+
+private:
+	FastNoiseLite FirstNoise;
+	FastNoiseLite SecondNoise;
+
+public:
+	UCaveCarverStage();
+
+	virtual void Init() override;
+	virtual bool ShouldGenerate(const FChunkConfig& ChunkConfig) const override;
+	virtual void Generate(const FChunkConfig& ChunkConfig, TChunkData& Blocks, const FGeneratorStageNeighbors& Neighbors) override;
+};
@@ -21,6 +21,11 @@ private:
 	UPROPERTY()
 	FChunkConfig ChunkConfig;
 
+	// One bit per pair of faces that see each other through non solid blocks, all until it is computed
+	uint16 FaceConnectivity = MAX_uint16;
+
+	static int32 GetFacePairIndex(int32 InFaceA, int32 InFaceB);
+
 public:
 	TMap<FIntVector, UChunk*>* WorldChunks;
 	
@@ -36,11 +41,19 @@ public:
 
 	UFUNCTION()
 	FBlock GetBlock(const FIntVector& Position) const;
+
+	// Packed sky and block light, full sky light outside of the loaded world
+	uint8 GetLight(const FIntVector& Position) const;
 	
 	
 	void SetBlocks(const TChunkData& InBlocks);
 
-	const TChunkData& GetBlocks();
+	const TChunkData& GetBlocks() const;
+	TChunkData& GetMutableBlocks();
+
+	// Faces in the order Top, Bottom, Front, Back, Right, Left
+	void UpdateFaceConnectivity();
+	bool AreFacesConnected(int32 InFaceA, int32 InFaceB) const;
 
 
 
@@ -16,6 +16,10 @@ class  TChunkData
 
 	FIntVector ChunkSize;
 	TArray<FBlock> Blocks;
+	// Sky light in the high and block light in the low nibble
+	TArray<uint8> Light;
+	// Fluid amount of fluid blocks, 0 is a full block
+	TArray<uint8> FluidLevels;
 
 private:
 	int32 GetBlockIndex(const FIntVector& Position) const;
@@ -26,6 +30,8 @@ public:
 	{
 		if(Blocks.IsEmpty())
 			Blocks.Init(Air, GetBlockIndex(InChunkSize-FIntVector(1))+1);
+		Light.Init(0, Blocks.Num());
+		FluidLevels.Init(0, Blocks.Num());
 	}
 
 public:
@@ -34,8 +40,19 @@ public:
 	void SetBlocks(const TArray<FBlock>& InBlocks);
 	const TArray<FBlock>& GetBlocks();
 	bool RemoveBlock(const FIntVector& Position);
+	// Sets the air blocks from MinZ to MaxZ of the column, returns how many were set
+	int32 FillColumn(int32 X, int32 Y, int32 MinZ, int32 MaxZ, const FBlock& Block);
 	bool IsEmpty() const;
 
+	uint8 GetLight(const FIntVector& Position) const;
+	uint8 GetSkyLight(const FIntVector& Position) const;
+	uint8 GetBlockLight(const FIntVector& Position) const;
+	void SetSkyLight(const FIntVector& Position, uint8 Level);
+	void SetBlockLight(const FIntVector& Position, uint8 Level);
+
+	uint8 GetFluidLevel(const FIntVector& Position) const;
+	void SetFluidLevel(const FIntVector& Position, uint8 Level);
+
 	const FIntVector& GetChunkSize() const
 	{
 		return ChunkSize;
@@ -0,0 +1,47 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FastNoiseLite.h"
+#include "Generator.h"
+#include "SimpleGenerator.h"
+#include "DensityGenerator.generated.h"
+
+/**
+ * Terrain from 3D density noise with overhangs and caves, a block is solid where the density is above 0.
+ * Density is sampled on a coarse lattice and trilinearly interpolated to the blocks.
+ */
+UCLASS(BlueprintType, Blueprintable)
+class CUBICWORLD_API UDensityGenerator final : public UGenerator
+{
+	GENERATED_BODY()
+public:
+	// Base surface height, the density falls off above it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FNoiseConfig HeightNoiseConfig;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FNoiseConfig DensityNoiseConfig;
+	// Blocks over which the density goes from the noise alone to fully air or solid, higher values give more overhangs
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin = 1.0))
+	float DensityFalloff = 16.0f;
+	// Blocks between two density samples, 1 samples every block
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin = 1, UIMax = 8))
+	int32 SampleSpacing = 4;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<FBlockLayer> Layers;
+
+private:
+	FastNoiseLite HeightNoise;
+	FastNoiseLite DensityNoise;
+	bool bHasBeenInitialized = false;
+
+	TOptional<FBlock> GetLayerBlock(int32 WorldZ, float MaxHeight, bool bIsTop) const;
+
+public:
+	UDensityGenerator();
+
+	virtual void Init() override;
+
+	virtual void GenerateChunk(const FChunkConfig& ChunkConfig, TChunkData& Blocks) override;
+};
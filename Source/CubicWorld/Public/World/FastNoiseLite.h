@@ -52,6 +52,17 @@
 
 #include <cmath>
 
+// Grid kernels for GetNoiseGrid2D/3D, define FNL_NO_SIMD to always use the scalar path
+#if !defined(FNL_NO_SIMD) && defined(__AVX2__)
+#define FNL_SIMD
+#define FNL_SIMD_AVX2
+#include <immintrin.h>
+#elif !defined(FNL_NO_SIMD) && (defined(__SSE4_1__) || (defined(PLATFORM_ALWAYS_HAS_SSE4_1) && PLATFORM_ALWAYS_HAS_SSE4_1))
+#define FNL_SIMD
+#define FNL_SIMD_SSE41
+#include <smmintrin.h>
+#endif
+
 class FastNoiseLite
 {
 public:
@@ -393,6 +404,81 @@ public:
         }
     }
 
+    /// <summary>
+    /// 2D noise for a grid of positions using current settings
+    /// </summary>
+    /// <remarks>
+    /// noiseOut[y * countX + x] = GetNoise(startX + x * step, startY + y * step)
+    /// OpenSimplex2 with no fractal or FBm runs 8 (AVX2) or 4 (SSE4.1) positions at a time,
+    /// everything else falls back to GetNoise per position
+    /// </remarks>
+    void GetNoiseGrid2D(float* noiseOut, float startX, float startY, int countX, int countY, float step = 1)
+    {
+        for (int y = 0; y < countY; y++)
+        {
+            float* rowOut = noiseOut + y * countX;
+            float yf = startY + y * step;
+            int x = 0;
+
+#ifdef FNL_SIMD
+            if (CanUseSimdGrid())
+            {
+                Simd::f32 yv = Simd::Set(yf);
+                for (; x + Simd::Size <= countX; x += Simd::Size)
+                {
+                    Simd::f32 xv = Simd::Add(Simd::Set(startX), Simd::Mul(Simd::Convert(Simd::Add(Simd::Set(x), Simd::Lanes())), Simd::Set(step)));
+                    Simd::Store(rowOut + x, GetNoiseSimd(xv, yv));
+                }
+            }
+#endif
+
+            for (; x < countX; x++)
+            {
+                rowOut[x] = GetNoise(startX + x * step, yf);
+            }
+        }
+    }
+
+    /// <summary>
+    /// 3D noise for a grid of positions using current settings
+    /// </summary>
+    /// <remarks>
+    /// noiseOut[(z * countY + y) * countX + x] = GetNoise(startX + x * step, startY + y * step, startZ + z * step)
+    /// OpenSimplex2 with no fractal or FBm runs 8 (AVX2) or 4 (SSE4.1) positions at a time,
+    /// everything else falls back to GetNoise per position
+    /// </remarks>
+    void GetNoiseGrid3D(float* noiseOut, float startX, float startY, float startZ, int countX, int countY, int countZ, float step = 1)
+    {
+        for (int z = 0; z < countZ; z++)
+        {
+            float zf = startZ + z * step;
+            for (int y = 0; y < countY; y++)
+            {
+                float* rowOut = noiseOut + (z * countY + y) * countX;
+                float yf = startY + y * step;
+                int x = 0;
+
+#ifdef FNL_SIMD
+                if (CanUseSimdGrid())
+                {
+                    Simd::f32 yv = Simd::Set(yf);
+                    Simd::f32 zv = Simd::Set(zf);
+                    for (; x + Simd::Size <= countX; x += Simd::Size)
+                    {
+                        Simd::f32 xv = Simd::Add(Simd::Set(startX), Simd::Mul(Simd::Convert(Simd::Add(Simd::Set(x), Simd::Lanes())), Simd::Set(step)));
+                        Simd::Store(rowOut + x, GetNoiseSimd(xv, yv, zv));
+                    }
+                }
+#endif
+
+                for (; x < countX; x++)
+                {
+                    rowOut[x] = GetNoise(startX + x * step, yf, zf);
+                }
+            }
+        }
+    }
+
 private:
     template <typename T>
     struct Arguments_must_be_floating_point_values;
@@ -2442,6 +2528,361 @@ private:
         yr += vy * warpAmp;
         zr += vz * warpAmp;
     }
+
+#ifdef FNL_SIMD
+    // SIMD grid kernels, each one repeats the float operations of its scalar counterpart in the same order,
+    // so results match GetNoise up to the sign of zero (unless the compiler contracts the scalar path into FMAs)
+
+#ifdef FNL_SIMD_AVX2
+    struct Simd
+    {
+        typedef __m256 f32;
+        typedef __m256i i32;
+        static const int Size = 8;
+
+        static f32 Set(float a) { return _mm256_set1_ps(a); }
+        static i32 Set(int a) { return _mm256_set1_epi32(a); }
+        static i32 Lanes() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+        static void Store(float* p, f32 a) { _mm256_storeu_ps(p, a); }
+
+        static f32 Add(f32 a, f32 b) { return _mm256_add_ps(a, b); }
+        static f32 Sub(f32 a, f32 b) { return _mm256_sub_ps(a, b); }
+        static f32 Mul(f32 a, f32 b) { return _mm256_mul_ps(a, b); }
+        static f32 Min(f32 a, f32 b) { return _mm256_min_ps(a, b); }
+        static f32 Neg(f32 a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+        static f32 And(f32 a, f32 b) { return _mm256_and_ps(a, b); }
+        static f32 Or(f32 a, f32 b) { return _mm256_or_ps(a, b); }
+        static f32 AndNot(f32 a, f32 b) { return _mm256_andnot_ps(a, b); }
+        static f32 Greater(f32 a, f32 b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static f32 GreaterEqual(f32 a, f32 b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+        static f32 Less(f32 a, f32 b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static f32 Select(f32 mask, f32 a, f32 b) { return _mm256_blendv_ps(b, a, mask); }
+
+        static i32 Add(i32 a, i32 b) { return _mm256_add_epi32(a, b); }
+        static i32 Sub(i32 a, i32 b) { return _mm256_sub_epi32(a, b); }
+        static i32 Mul(i32 a, i32 b) { return _mm256_mullo_epi32(a, b); }
+        static i32 And(i32 a, i32 b) { return _mm256_and_si256(a, b); }
+        static i32 Or(i32 a, i32 b) { return _mm256_or_si256(a, b); }
+        static i32 Xor(i32 a, i32 b) { return _mm256_xor_si256(a, b); }
+        static i32 ShiftRight(i32 a, int count) { return _mm256_sra_epi32(a, _mm_cvtsi32_si128(count)); }
+        static i32 Select(f32 mask, i32 a, i32 b) { return _mm256_blendv_epi8(b, a, _mm256_castps_si256(mask)); }
+        static i32 MaskToInt(f32 mask) { return _mm256_castps_si256(mask); }
+
+        static i32 Truncate(f32 a) { return _mm256_cvttps_epi32(a); }
+        static f32 Convert(i32 a) { return _mm256_cvtepi32_ps(a); }
+        static f32 Gather(const float* table, i32 index) { return _mm256_i32gather_ps(table, index, 4); }
+    };
+#else
+    struct Simd
+    {
+        typedef __m128 f32;
+        typedef __m128i i32;
+        static const int Size = 4;
+
+        static f32 Set(float a) { return _mm_set1_ps(a); }
+        static i32 Set(int a) { return _mm_set1_epi32(a); }
+        static i32 Lanes() { return _mm_setr_epi32(0, 1, 2, 3); }
+        static void Store(float* p, f32 a) { _mm_storeu_ps(p, a); }
+
+        static f32 Add(f32 a, f32 b) { return _mm_add_ps(a, b); }
+        static f32 Sub(f32 a, f32 b) { return _mm_sub_ps(a, b); }
+        static f32 Mul(f32 a, f32 b) { return _mm_mul_ps(a, b); }
+        static f32 Min(f32 a, f32 b) { return _mm_min_ps(a, b); }
+        static f32 Neg(f32 a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+        static f32 And(f32 a, f32 b) { return _mm_and_ps(a, b); }
+        static f32 Or(f32 a, f32 b) { return _mm_or_ps(a, b); }
+        static f32 AndNot(f32 a, f32 b) { return _mm_andnot_ps(a, b); }
+        static f32 Greater(f32 a, f32 b) { return _mm_cmpgt_ps(a, b); }
+        static f32 GreaterEqual(f32 a, f32 b) { return _mm_cmpge_ps(a, b); }
+        static f32 Less(f32 a, f32 b) { return _mm_cmplt_ps(a, b); }
+        static f32 Select(f32 mask, f32 a, f32 b) { return _mm_blendv_ps(b, a, mask); }
+
+        static i32 Add(i32 a, i32 b) { return _mm_add_epi32(a, b); }
+        static i32 Sub(i32 a, i32 b) { return _mm_sub_epi32(a, b); }
+        static i32 Mul(i32 a, i32 b) { return _mm_mullo_epi32(a, b); }
+        static i32 And(i32 a, i32 b) { return _mm_and_si128(a, b); }
+        static i32 Or(i32 a, i32 b) { return _mm_or_si128(a, b); }
+        static i32 Xor(i32 a, i32 b) { return _mm_xor_si128(a, b); }
+        static i32 ShiftRight(i32 a, int count) { return _mm_sra_epi32(a, _mm_cvtsi32_si128(count)); }
+        static i32 Select(f32 mask, i32 a, i32 b) { return _mm_blendv_epi8(b, a, _mm_castps_si128(mask)); }
+        static i32 MaskToInt(f32 mask) { return _mm_castps_si128(mask); }
+
+        static i32 Truncate(f32 a) { return _mm_cvttps_epi32(a); }
+        static f32 Convert(i32 a) { return _mm_cvtepi32_ps(a); }
+        static f32 Gather(const float* table, i32 index)
+        {
+            return _mm_setr_ps(table[_mm_extract_epi32(index, 0)], table[_mm_extract_epi32(index, 1)],
+                table[_mm_extract_epi32(index, 2)], table[_mm_extract_epi32(index, 3)]);
+        }
+    };
+#endif
+
+    bool CanUseSimdGrid() const
+    {
+        // Ridged and PingPong use the scalar path, every other fractal type is single noise in GetNoise
+        return mNoiseType == NoiseType_OpenSimplex2 && mFractalType != FractalType_Ridged && mFractalType != FractalType_PingPong;
+    }
+
+    static Simd::i32 FastFloorSimd(Simd::f32 f)
+    {
+        // All bits set is -1
+        return Simd::Add(Simd::Truncate(f), Simd::MaskToInt(Simd::Less(f, Simd::Set(0.0f))));
+    }
+
+    static Simd::i32 FastRoundSimd(Simd::f32 f)
+    {
+        return Simd::Truncate(Simd::Add(f, Simd::Select(Simd::GreaterEqual(f, Simd::Set(0.0f)), Simd::Set(0.5f), Simd::Set(-0.5f))));
+    }
+
+    static Simd::f32 GradCoordSimd(int seed, Simd::i32 xPrimed, Simd::i32 yPrimed, Simd::f32 xd, Simd::f32 yd)
+    {
+        Simd::i32 hash = Simd::Xor(Simd::Xor(Simd::Set(seed), xPrimed), yPrimed);
+        hash = Simd::Mul(hash, Simd::Set(0x27d4eb2d));
+        hash = Simd::Xor(hash, Simd::ShiftRight(hash, 15));
+        hash = Simd::And(hash, Simd::Set(127 << 1));
+
+        Simd::f32 xg = Simd::Gather(Lookup<float>::Gradients2D, hash);
+        Simd::f32 yg = Simd::Gather(Lookup<float>::Gradients2D, Simd::Or(hash, Simd::Set(1)));
+
+        return Simd::Add(Simd::Mul(xd, xg), Simd::Mul(yd, yg));
+    }
+
+    static Simd::f32 GradCoordSimd(int seed, Simd::i32 xPrimed, Simd::i32 yPrimed, Simd::i32 zPrimed, Simd::f32 xd, Simd::f32 yd, Simd::f32 zd)
+    {
+        Simd::i32 hash = Simd::Xor(Simd::Xor(Simd::Xor(Simd::Set(seed), xPrimed), yPrimed), zPrimed);
+        hash = Simd::Mul(hash, Simd::Set(0x27d4eb2d));
+        hash = Simd::Xor(hash, Simd::ShiftRight(hash, 15));
+        hash = Simd::And(hash, Simd::Set(63 << 2));
+
+        Simd::f32 xg = Simd::Gather(Lookup<float>::Gradients3D, hash);
+        Simd::f32 yg = Simd::Gather(Lookup<float>::Gradients3D, Simd::Or(hash, Simd::Set(1)));
+        Simd::f32 zg = Simd::Gather(Lookup<float>::Gradients3D, Simd::Or(hash, Simd::Set(2)));
+
+        return Simd::Add(Simd::Add(Simd::Mul(xd, xg), Simd::Mul(yd, yg)), Simd::Mul(zd, zg));
+    }
+
+    Simd::f32 GetNoiseSimd(Simd::f32 x, Simd::f32 y) const
+    {
+        // TransformNoiseCoordinate for OpenSimplex2
+        const float SQRT3 = (float)1.7320508075688772935274463415059;
+        const float F2 = 0.5f * (SQRT3 - 1);
+
+        x = Simd::Mul(x, Simd::Set(mFrequency));
+        y = Simd::Mul(y, Simd::Set(mFrequency));
+        Simd::f32 t = Simd::Mul(Simd::Add(x, y), Simd::Set(F2));
+        x = Simd::Add(x, t);
+        y = Simd::Add(y, t);
+
+        if (mFractalType != FractalType_FBm)
+        {
+            return SingleSimplexSimd(mSeed, x, y);
+        }
+
+        int seed = mSeed;
+        Simd::f32 sum = Simd::Set(0.0f);
+        Simd::f32 amp = Simd::Set(mFractalBounding);
+
+        for (int i = 0; i < mOctaves; i++)
+        {
+            Simd::f32 noise = SingleSimplexSimd(seed++, x, y);
+            sum = Simd::Add(sum, Simd::Mul(noise, amp));
+            Simd::f32 weight = Simd::Mul(Simd::Min(Simd::Add(noise, Simd::Set(1.0f)), Simd::Set(2.0f)), Simd::Set(0.5f));
+            amp = Simd::Mul(amp, Simd::Add(Simd::Set(1.0f), Simd::Mul(Simd::Set(mWeightedStrength), Simd::Sub(weight, Simd::Set(1.0f)))));
+
+            x = Simd::Mul(x, Simd::Set(mLacunarity));
+            y = Simd::Mul(y, Simd::Set(mLacunarity));
+            amp = Simd::Mul(amp, Simd::Set(mGain));
+        }
+
+        return sum;
+    }
+
+    Simd::f32 GetNoiseSimd(Simd::f32 x, Simd::f32 y, Simd::f32 z) const
+    {
+        x = Simd::Mul(x, Simd::Set(mFrequency));
+        y = Simd::Mul(y, Simd::Set(mFrequency));
+        z = Simd::Mul(z, Simd::Set(mFrequency));
+
+        switch (mTransformType3D)
+        {
+        case TransformType3D_ImproveXYPlanes:
+            {
+                Simd::f32 xy = Simd::Add(x, y);
+                Simd::f32 s2 = Simd::Mul(xy, Simd::Set(-(float)0.211324865405187));
+                z = Simd::Mul(z, Simd::Set((float)0.577350269189626));
+                x = Simd::Add(x, Simd::Sub(s2, z));
+                y = Simd::Sub(Simd::Add(y, s2), z);
+                z = Simd::Add(z, Simd::Mul(xy, Simd::Set((float)0.577350269189626)));
+            }
+            break;
+        case TransformType3D_ImproveXZPlanes:
+            {
+                Simd::f32 xz = Simd::Add(x, z);
+                Simd::f32 s2 = Simd::Mul(xz, Simd::Set(-(float)0.211324865405187));
+                y = Simd::Mul(y, Simd::Set((float)0.577350269189626));
+                x = Simd::Add(x, Simd::Sub(s2, y));
+                z = Simd::Add(z, Simd::Sub(s2, y));
+                y = Simd::Add(y, Simd::Mul(xz, Simd::Set((float)0.577350269189626)));
+            }
+            break;
+        case TransformType3D_DefaultOpenSimplex2:
+            {
+                Simd::f32 r = Simd::Mul(Simd::Add(Simd::Add(x, y), z), Simd::Set((float)(2.0 / 3.0)));
+                x = Simd::Sub(r, x);
+                y = Simd::Sub(r, y);
+                z = Simd::Sub(r, z);
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (mFractalType != FractalType_FBm)
+        {
+            return SingleOpenSimplex2Simd(mSeed, x, y, z);
+        }
+
+        int seed = mSeed;
+        Simd::f32 sum = Simd::Set(0.0f);
+        Simd::f32 amp = Simd::Set(mFractalBounding);
+
+        for (int i = 0; i < mOctaves; i++)
+        {
+            Simd::f32 noise = SingleOpenSimplex2Simd(seed++, x, y, z);
+            sum = Simd::Add(sum, Simd::Mul(noise, amp));
+            Simd::f32 weight = Simd::Mul(Simd::Add(noise, Simd::Set(1.0f)), Simd::Set(0.5f));
+            amp = Simd::Mul(amp, Simd::Add(Simd::Set(1.0f), Simd::Mul(Simd::Set(mWeightedStrength), Simd::Sub(weight, Simd::Set(1.0f)))));
+
+            x = Simd::Mul(x, Simd::Set(mLacunarity));
+            y = Simd::Mul(y, Simd::Set(mLacunarity));
+            z = Simd::Mul(z, Simd::Set(mLacunarity));
+            amp = Simd::Mul(amp, Simd::Set(mGain));
+        }
+
+        return sum;
+    }
+
+    static Simd::f32 SingleSimplexSimd(int seed, Simd::f32 x, Simd::f32 y)
+    {
+        const float SQRT3 = 1.7320508075688772935274463415059f;
+        const float G2 = (3 - SQRT3) / 6;
+
+        Simd::f32 zero = Simd::Set(0.0f);
+
+        Simd::i32 i = FastFloorSimd(x);
+        Simd::i32 j = FastFloorSimd(y);
+        Simd::f32 xi = Simd::Sub(x, Simd::Convert(i));
+        Simd::f32 yi = Simd::Sub(y, Simd::Convert(j));
+
+        Simd::f32 t = Simd::Mul(Simd::Add(xi, yi), Simd::Set(G2));
+        Simd::f32 x0 = Simd::Sub(xi, t);
+        Simd::f32 y0 = Simd::Sub(yi, t);
+
+        i = Simd::Mul(i, Simd::Set(PrimeX));
+        j = Simd::Mul(j, Simd::Set(PrimeY));
+
+        Simd::f32 a = Simd::Sub(Simd::Sub(Simd::Set(0.5f), Simd::Mul(x0, x0)), Simd::Mul(y0, y0));
+        Simd::f32 n0 = Simd::And(Simd::Greater(a, zero),
+            Simd::Mul(Simd::Mul(Simd::Mul(a, a), Simd::Mul(a, a)), GradCoordSimd(seed, i, j, x0, y0)));
+
+        Simd::f32 c = Simd::Add(Simd::Mul(Simd::Set((float)(2 * (1 - 2 * G2) * (1 / G2 - 2))), t),
+            Simd::Add(Simd::Set((float)(-2 * (1 - 2 * G2) * (1 - 2 * G2))), a));
+        Simd::f32 x2 = Simd::Add(x0, Simd::Set(2 * (float)G2 - 1));
+        Simd::f32 y2 = Simd::Add(y0, Simd::Set(2 * (float)G2 - 1));
+        Simd::f32 n2 = Simd::And(Simd::Greater(c, zero),
+            Simd::Mul(Simd::Mul(Simd::Mul(c, c), Simd::Mul(c, c)), GradCoordSimd(seed, Simd::Add(i, Simd::Set(PrimeX)), Simd::Add(j, Simd::Set(PrimeY)), x2, y2)));
+
+        // Both branches of the y0 > x0 test, picked per lane
+        Simd::f32 yAbove = Simd::Greater(y0, x0);
+        Simd::f32 x1 = Simd::Add(x0, Simd::Select(yAbove, Simd::Set((float)G2), Simd::Set((float)G2 - 1)));
+        Simd::f32 y1 = Simd::Add(y0, Simd::Select(yAbove, Simd::Set((float)G2 - 1), Simd::Set((float)G2)));
+        Simd::i32 i1 = Simd::Select(yAbove, i, Simd::Add(i, Simd::Set(PrimeX)));
+        Simd::i32 j1 = Simd::Select(yAbove, Simd::Add(j, Simd::Set(PrimeY)), j);
+        Simd::f32 b = Simd::Sub(Simd::Sub(Simd::Set(0.5f), Simd::Mul(x1, x1)), Simd::Mul(y1, y1));
+        Simd::f32 n1 = Simd::And(Simd::Greater(b, zero),
+            Simd::Mul(Simd::Mul(Simd::Mul(b, b), Simd::Mul(b, b)), GradCoordSimd(seed, i1, j1, x1, y1)));
+
+        return Simd::Mul(Simd::Add(Simd::Add(n0, n1), n2), Simd::Set(99.83685446303647f));
+    }
+
+    static Simd::f32 SingleOpenSimplex2Simd(int seed, Simd::f32 x, Simd::f32 y, Simd::f32 z)
+    {
+        Simd::f32 zero = Simd::Set(0.0f);
+
+        Simd::i32 i = FastRoundSimd(x);
+        Simd::i32 j = FastRoundSimd(y);
+        Simd::i32 k = FastRoundSimd(z);
+        Simd::f32 x0 = Simd::Sub(x, Simd::Convert(i));
+        Simd::f32 y0 = Simd::Sub(y, Simd::Convert(j));
+        Simd::f32 z0 = Simd::Sub(z, Simd::Convert(k));
+
+        Simd::i32 xNSign = Simd::Or(Simd::Truncate(Simd::Sub(Simd::Set(-1.0f), x0)), Simd::Set(1));
+        Simd::i32 yNSign = Simd::Or(Simd::Truncate(Simd::Sub(Simd::Set(-1.0f), y0)), Simd::Set(1));
+        Simd::i32 zNSign = Simd::Or(Simd::Truncate(Simd::Sub(Simd::Set(-1.0f), z0)), Simd::Set(1));
+
+        Simd::f32 ax0 = Simd::Mul(Simd::Convert(xNSign), Simd::Neg(x0));
+        Simd::f32 ay0 = Simd::Mul(Simd::Convert(yNSign), Simd::Neg(y0));
+        Simd::f32 az0 = Simd::Mul(Simd::Convert(zNSign), Simd::Neg(z0));
+
+        i = Simd::Mul(i, Simd::Set(PrimeX));
+        j = Simd::Mul(j, Simd::Set(PrimeY));
+        k = Simd::Mul(k, Simd::Set(PrimeZ));
+
+        Simd::f32 value = zero;
+        Simd::f32 a = Simd::Sub(Simd::Sub(Simd::Set(0.6f), Simd::Mul(x0, x0)), Simd::Add(Simd::Mul(y0, y0), Simd::Mul(z0, z0)));
+
+        for (int l = 0; ; l++)
+        {
+            value = Simd::Add(value, Simd::And(Simd::Greater(a, zero),
+                Simd::Mul(Simd::Mul(Simd::Mul(a, a), Simd::Mul(a, a)), GradCoordSimd(seed, i, j, k, x0, y0, z0))));
+
+            // The scalar if / else if / else on the largest axis as three exclusive lane masks
+            Simd::f32 xMax = Simd::And(Simd::GreaterEqual(ax0, ay0), Simd::GreaterEqual(ax0, az0));
+            Simd::f32 yMax = Simd::AndNot(xMax, Simd::And(Simd::Greater(ay0, ax0), Simd::GreaterEqual(ay0, az0)));
+            Simd::f32 notZMax = Simd::Or(xMax, yMax);
+
+            Simd::f32 x1 = Simd::Select(xMax, Simd::Add(x0, Simd::Convert(xNSign)), x0);
+            Simd::f32 y1 = Simd::Select(yMax, Simd::Add(y0, Simd::Convert(yNSign)), y0);
+            Simd::f32 z1 = Simd::Select(notZMax, z0, Simd::Add(z0, Simd::Convert(zNSign)));
+
+            Simd::f32 bx = Simd::Mul(Simd::Convert(Simd::Add(xNSign, xNSign)), x1);
+            Simd::f32 by = Simd::Mul(Simd::Convert(Simd::Add(yNSign, yNSign)), y1);
+            Simd::f32 bz = Simd::Mul(Simd::Convert(Simd::Add(zNSign, zNSign)), z1);
+            Simd::f32 b = Simd::Sub(Simd::Add(a, Simd::Set(1.0f)), Simd::Select(xMax, bx, Simd::Select(yMax, by, bz)));
+
+            Simd::i32 i1 = Simd::Select(xMax, Simd::Sub(i, Simd::Mul(xNSign, Simd::Set(PrimeX))), i);
+            Simd::i32 j1 = Simd::Select(yMax, Simd::Sub(j, Simd::Mul(yNSign, Simd::Set(PrimeY))), j);
+            Simd::i32 k1 = Simd::Select(notZMax, k, Simd::Sub(k, Simd::Mul(zNSign, Simd::Set(PrimeZ))));
+
+            value = Simd::Add(value, Simd::And(Simd::Greater(b, zero),
+                Simd::Mul(Simd::Mul(Simd::Mul(b, b), Simd::Mul(b, b)), GradCoordSimd(seed, i1, j1, k1, x1, y1, z1))));
+
+            if (l == 1) break;
+
+            ax0 = Simd::Sub(Simd::Set(0.5f), ax0);
+            ay0 = Simd::Sub(Simd::Set(0.5f), ay0);
+            az0 = Simd::Sub(Simd::Set(0.5f), az0);
+
+            x0 = Simd::Mul(Simd::Convert(xNSign), ax0);
+            y0 = Simd::Mul(Simd::Convert(yNSign), ay0);
+            z0 = Simd::Mul(Simd::Convert(zNSign), az0);
+
+            a = Simd::Add(a, Simd::Sub(Simd::Sub(Simd::Set(0.75f), ax0), Simd::Add(ay0, az0)));
+
+            i = Simd::Add(i, Simd::And(Simd::ShiftRight(xNSign, 1), Simd::Set(PrimeX)));
+            j = Simd::Add(j, Simd::And(Simd::ShiftRight(yNSign, 1), Simd::Set(PrimeY)));
+            k = Simd::Add(k, Simd::And(Simd::ShiftRight(zNSign, 1), Simd::Set(PrimeZ)));
+
+            xNSign = Simd::Sub(Simd::Set(0), xNSign);
+            yNSign = Simd::Sub(Simd::Set(0), yNSign);
+            zNSign = Simd::Sub(Simd::Set(0), zNSign);
+
+            seed = ~seed;
+        }
+
+        return Simd::Mul(value, Simd::Set(32.69428253173828125f));
+    }
+#endif
 };
 
 template <>
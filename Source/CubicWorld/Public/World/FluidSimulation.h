@@ -0,0 +1,64 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Chunk.h"
+
+/**
+ * Cellular automaton for water and lava that only steps the cells around recent changes
+ */
+class CUBICWORLD_API FFluidSimulation
+{
+public:
+	static constexpr uint8 MaxLevel = 8;
+
+	FFluidSimulation(TMap<FIntVector, UChunk*>* InChunks, const FWorldConfig& InWorldConfig);
+
+	void Activate(const FIntVector& InBlockPosition);
+	void ActivateChunk(const FIntVector& InChunkPosition);
+	void UpdateBlock(const FIntVector& InBlockPosition, const FBlock& InOldBlock, const FBlock& InNewBlock);
+	void SetLevel(const FIntVector& InBlockPosition, uint8 InLevel);
+	uint8 GetLevel(const FIntVector& InBlockPosition) const;
+	bool IsFluid(const FBlock& InBlock) const;
+
+	// Runs the steps due since the last call, block changes are left to the caller to apply in one batch
+	void Tick(float InDeltaTime, TArray<TPair<FIntVector, FBlock>>& OutBlockChanges);
+
+	int32 GetActiveCellCount() const
+	{
+		return ActiveCells.Num();
+	}
+
+private:
+	struct FFluidCell
+	{
+		FBlock Block;
+		uint8 Level = 0;
+		bool bIsLoaded = false;
+		bool bCanHoldFluid = false;
+	};
+
+	struct FFluidFlow
+	{
+		FIntVector Source;
+		FBlock Fluid;
+		int32 Count = 0;
+		FIntVector Targets[5];
+		uint8 Amounts[5];
+		// Not due this step, stays active without flowing
+		bool bKeepActive = false;
+	};
+
+	TMap<FIntVector, UChunk*>* Chunks;
+	FWorldConfig WorldConfig;
+
+	TSet<FIntVector> ActiveCells;
+	float Accumulator = 0.0f;
+	uint32 StepCount = 0;
+
+	UChunk* FindChunk(const FIntVector& InBlockPosition, FIntVector& OutLocalPosition) const;
+	FFluidCell GetCell(const FIntVector& InBlockPosition) const;
+	void Step(TArray<TPair<FIntVector, FBlock>>& OutBlockChanges);
+	void ComputeFlow(const FIntVector& InBlockPosition, FFluidFlow& OutFlow) const;
+};
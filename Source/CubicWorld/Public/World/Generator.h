@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "ChunkData.h"
+#include "GeneratorStage.h"
 #include "Structs/ChunkConfig.h"
 #include "Structs/Block.h"
 #include "UObject/Object.h"
@@ -17,10 +18,31 @@ class CUBICWORLD_API UGenerator : public UObject
 {
 	GENERATED_BODY()
 public:
-	void GenerateChunk(const FChunkConfig& ChunkConfig, TChunkData& Blocks);
+	// Run in order on every chunk after GenerateChunk
+	UPROPERTY(EditAnywhere, Instanced, BlueprintReadOnly, Category="Stages")
+	TArray<UGeneratorStage*> Stages;
+
+	// Called once on the generator thread before any chunk is generated, chunks are generated in parallel afterwards
+	virtual void Init() {}
+
+	// Fills the air blocks of the chunk, calls GetTile per block unless a subclass generates whole chunks
+	virtual void GenerateChunk(const FChunkConfig& ChunkConfig, TChunkData& Blocks);
 	
 	virtual TOptional<FBlock> GetTile(const FIntVector &Position, const FWorldConfig &WorldConfig)
 	{
 		return TOptional<FBlock>();
 	}
+
+	// Lowest and highest surface block in world block Z over the columns of the chunk, false if the generator can't tell.
+	// Chunks above the range are left as air without calling GetTile
+	virtual bool GetHeightRange(const FChunkConfig& ChunkConfig, int32& OutMinHeight, int32& OutMaxHeight)
+	{
+		return false;
+	}
+
+	// Block of every column between MinZ and MaxZ below the surface if it is the same everywhere
+	virtual TOptional<FBlock> GetSolidFill(const FChunkConfig& ChunkConfig, int32 MinZ, int32 MaxZ)
+	{
+		return TOptional<FBlock>();
+	}
 };
@@ -8,7 +8,9 @@
 #include "Structs/Block.h"
 
 /**
- *
+ * Generates the requested chunks on its own thread, running the terrain and then every stage of the generator.
+ * A stage only runs on a chunk once the chunks in its dependency radius finished the stages before it,
+ * those are generated as far as needed without being handed out. Independent steps run in parallel.
  */
 
 class CUBICWORLD_API FGeneratorRunner final : public FRunnable
@@ -18,6 +20,9 @@ public:
 	TQueue<TPair<FIntVector, TChunkData>> Results;
 
 	FGeneratorRunner(UGenerator *InGenerator, const FWorldConfig &InWorldConfig);
+	void AddTask(const FIntVector& InChunkPosition, const TChunkData& InBlocks);
+	// Skips the queued task of the chunk, a chunk that is already generated still shows up in the results
+	void CancelTask(const FIntVector& InChunkPosition);
 	virtual uint32 Run() override;
 	virtual bool Init() override;
 	virtual void Stop() override;
@@ -28,6 +33,34 @@ private:
 	bool bShouldRun = true;
 	bool bHasStopped = false;
 
+	FCriticalSection CancelledSyncRoot;
+	TSet<FIntVector> Cancelled;
+
 	UGenerator *const Generator;
 	FWorldConfig WorldConfig;
+
+	// Only used on the generator thread
+	struct FPipelineChunk
+	{
+		TChunkData Blocks;
+		// Steps done and needed, the terrain is step 0 and stage n is step n + 1
+		int32 Done = 0;
+		int32 Target = 0;
+		bool bRequested = false;
+		// Chunks this one waits for, and how many chunks wait for this one
+		TSet<FIntVector> Required;
+		int32 Users = 0;
+	};
+	TMap<FIntVector, FPipelineChunk> Pipeline;
+	TArray<UGeneratorStage*> Stages;
+
+	int32 GetStepCount() const;
+	int32 GetDependencyRadius(int32 InStep) const;
+	void ForEachDependency(const FIntVector& InChunkPosition, int32 InStep, TFunctionRef<void(const FIntVector&)> InFunction) const;
+	void Require(const FIntVector& InChunkPosition, int32 InTarget);
+	void ReleaseRequired(const FIntVector& InChunkPosition);
+	void DropIfUnused(const FIntVector& InChunkPosition);
+	void FinishStep(const FIntVector& InChunkPosition);
+	void RunStep(const FIntVector& InChunkPosition);
+	bool RunReadySteps();
 };
\ No newline at end of file
@@ -0,0 +1,57 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChunkData.h"
+#include "Structs/ChunkConfig.h"
+#include "Structs/Block.h"
+#include "UObject/Object.h"
+#include "GeneratorStage.generated.h"
+
+/**
+ * Read only blocks of the chunks within the dependency radius of a stage.
+ * They have finished at least the stages before it, stages should only read what earlier stages wrote.
+ */
+struct CUBICWORLD_API FGeneratorStageNeighbors
+{
+	FIntVector ChunkSize;
+	TMap<FIntVector, const TChunkData*> Chunks;
+
+	explicit FGeneratorStageNeighbors(const FIntVector& InChunkSize): ChunkSize(InChunkSize) {}
+
+	// Null for chunks outside of the radius and for the chunk the stage writes
+	const TChunkData* GetChunk(const FIntVector& InChunkPosition) const;
+	// Air outside of the radius
+	FBlock GetBlock(const FIntVector& InWorldBlockPosition) const;
+};
+
+/**
+ * One step of chunk generation after the terrain of the generator, running on whole chunks.
+ * Stages of different chunks run in parallel, Generate must not change the stage.
+ */
+UCLASS(Abstract, BlueprintType, EditInlineNew, DefaultToInstanced)
+class CUBICWORLD_API UGeneratorStage : public UObject
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	bool bEnabled = true;
+	// Chunks around this one that must have finished the earlier stages before this stage runs
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ClampMin = 0, UIMax = 2))
+	int32 DependencyRadius = 0;
+	// Waits for every chunk of the columns in the radius instead of a cube, so the surface can be found at any height
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	bool bDependsOnWholeColumns = false;
+
+	// Called once on the generator thread before any chunk is generated
+	virtual void Init() {}
+
+	virtual bool ShouldGenerate(const FChunkConfig& ChunkConfig) const
+	{
+		return bEnabled;
+	}
+
+	// Only writes the blocks of its own chunk, the neighbors place their part of anything crossing the border themselves
+	virtual void Generate(const FChunkConfig& ChunkConfig, TChunkData& Blocks, const FGeneratorStageNeighbors& Neighbors) {}
+};
@@ -0,0 +1,80 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trackable.h"
+#include "Structs/WorldConfig.h"
+
+/**
+ * Merges the chunk windows of all trackables into refcounted chunk columns and hands out loads fairly between them
+ */
+class CUBICWORLD_API FInterestManager
+{
+public:
+	enum ETier
+	{
+		// Stays loaded
+		Keep	= 0,
+		// Gets loaded
+		Load	= 1,
+		// Gets meshed
+		Visible	= 2
+	};
+
+	explicit FInterestManager(const FWorldConfig& InWorldConfig);
+
+	// Only walks the columns that enter or leave the windows of the trackable
+	void UpdateViewer(const UTrackable* InViewer, const FVector& InPosition, int32 InDistance);
+	// Columns on the predicted path are kept and loaded but not meshed
+	void SetPrefetchColumns(const UTrackable* InViewer, const TSet<FIntPoint>& InColumns);
+	void RemoveViewersExcept(const TSet<TObjectKey<UTrackable>>& InViewers);
+
+	bool HasInterest(const FIntPoint& InColumn, ETier InTier) const;
+
+	// One column per trackable in turn so a crowd in one place can't starve a single player elsewhere
+	void GetColumnsToLoad(int32 InMaxColumns, TFunctionRef<bool(const FIntPoint&)> InIsRequested, TArray<FIntPoint>& OutColumns);
+	// Columns whose Keep or Visible interest started or ended since the last call
+	void ConsumeChanges(TSet<FIntPoint>& OutKeepChanged, TSet<FIntPoint>& OutVisibleChanged);
+
+	int32 GetViewerCount() const
+	{
+		return Viewers.Num();
+	}
+
+	int32 GetColumnCount() const
+	{
+		return Columns.Num();
+	}
+
+private:
+	struct FColumnInterest
+	{
+		int32 Counts[3] = {0, 0, 0};
+	};
+
+	struct FViewer
+	{
+		TWeakObjectPtr<const UTrackable> Trackable;
+		FVector Position;
+		FIntRect Windows[3];
+		TSet<FIntPoint> Prefetch;
+		// Best column last
+		TArray<FIntPoint> LoadQueue;
+	};
+
+	FWorldConfig WorldConfig;
+	TMap<FIntPoint, FColumnInterest> Columns;
+	TMap<TObjectKey<UTrackable>, FViewer> Viewers;
+	TArray<TObjectKey<UTrackable>> ViewerOrder;
+	int32 NextViewer = 0;
+
+	TSet<FIntPoint> KeepChanged;
+	TSet<FIntPoint> VisibleChanged;
+
+	void AddInterest(const FIntPoint& InColumn, ETier InTier, int32 InDelta);
+	void SetPrefetchColumns(FViewer& InOutViewer, const TSet<FIntPoint>& InColumns);
+	void MoveWindow(FViewer& InOutViewer, ETier InTier, const FIntRect& InWindow);
+	bool WantsLoad(const FViewer& InViewer, const FIntPoint& InColumn) const;
+	void RemoveViewer(const TObjectKey<UTrackable>& InViewer);
+};
@@ -0,0 +1,54 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Chunk.h"
+
+/**
+ * Flood fill sky and block light through the loaded chunks and keeps it up to date when blocks change
+ */
+class CUBICWORLD_API FLightEngine
+{
+public:
+	enum EChannel
+	{
+		Sky		= 0,
+		Block	= 1
+	};
+
+	static constexpr uint8 MaxLight = 15;
+
+	FLightEngine(TMap<FIntVector, UChunk*>* InChunks, const FWorldConfig& InWorldConfig);
+
+	void AddChunk(const FIntVector& InChunkPosition);
+	void UpdateBlock(const FIntVector& InBlockPosition, const FBlock& InOldBlock, const FBlock& InNewBlock);
+	void Propagate(TSet<FIntVector>& OutChangedChunks);
+
+private:
+	struct FLightNode
+	{
+		FIntVector Position;
+		// 0 spreads the light the block currently has
+		uint8 Level;
+	};
+
+	TMap<FIntVector, UChunk*>* Chunks;
+	FWorldConfig WorldConfig;
+
+	TArray<FLightNode> AddQueues[2];
+	TArray<FLightNode> RemoveQueues[2];
+	TSet<FIntVector> ChangedChunks;
+
+	UChunk* CachedChunk = nullptr;
+	FIntVector CachedChunkPosition;
+
+	UChunk* FindChunk(const FIntVector& InBlockPosition, FIntVector& OutLocalPosition);
+	bool IsOpaque(const FBlock& InBlock) const;
+	uint8 GetEmission(const FBlock& InBlock) const;
+	static uint8 GetLight(EChannel InChannel, const UChunk* InChunk, const FIntVector& InLocalPosition);
+	void SetLight(EChannel InChannel, UChunk* InChunk, const FIntVector& InLocalPosition, uint8 InLevel);
+
+	void PropagateRemoval(EChannel InChannel);
+	void PropagateAdd(EChannel InChannel);
+};
@@ -61,10 +61,20 @@ private:
 	FastNoiseLite Noise;
 	FastNoiseLite DistortionNoise;
 	bool bHasBeenInitialized = false;
-	void Init();
 
 	float GetNoise(float X, float Y);
+	// Surface height of every column of the chunk, the same GetTile computes per block
+	void GetColumnHeights(const FChunkConfig& ChunkConfig, TArray<int32>& OutHeights);
+	// First world block Z above the layer
+	static int32 GetLayerTop(float LayerHeight, int32 MaxHeight);
 
 public:
+	// Fills the column up to ColumnHeight with one run per layer, the same blocks GetTile gives. Layers are sorted by height
+	static void FillLayerColumn(const FChunkConfig& ChunkConfig, TChunkData& Blocks, int32 X, int32 Y, int32 ColumnHeight, const TArray<FBlockLayer>& Layers, float Distortion = 0.0f);
+	virtual void Init() override;
+	// Fills each column with one run per layer instead of calling GetTile per block
+	virtual void GenerateChunk(const FChunkConfig& ChunkConfig, TChunkData& Blocks) override;
 	virtual TOptional<FBlock> GetTile(const FIntVector &Position, const FWorldConfig &WorldConfig) override;
+	virtual bool GetHeightRange(const FChunkConfig& ChunkConfig, int32& OutMinHeight, int32& OutMaxHeight) override;
+	virtual TOptional<FBlock> GetSolidFill(const FChunkConfig& ChunkConfig, int32 MinZ, int32 MaxZ) override;
 };
@@ -0,0 +1,34 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Block.h"
+#include "BlockHitResult.generated.h"
+
+/**
+ * Result of a voxel query against the loaded chunks
+ */
+USTRUCT(BlueprintType)
+struct FBlockHitResult
+{
+	GENERATED_BODY()
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bBlockingHit = false;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bStartPenetrating = false;
+	// Fraction of the trace or sweep at which the hit happened
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	float Time = 1.0f;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FVector Location = FVector::ZeroVector;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FVector Normal = FVector::ZeroVector;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FIntVector BlockPosition = FIntVector::ZeroValue;
+	// Last empty block the trace passed before the hit, where a block would be placed
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FIntVector PreviousBlockPosition = FIntVector::ZeroValue;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FBlock Block;
+};
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "BlockType.generated.h"
 
+class UBlockTickHandler;
+
 /**
  * 
  */
@@ -16,6 +18,19 @@ struct FBlockType
     FString BlockName = "";
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	bool bIsSolid = true;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta=(UIMin = 0, UIMax = 15, ClampMax = 15))
+	uint8 LightEmission = 0;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bIsFluid = false;
+	// Fluid only flows every n simulation steps, lava is slower than water
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta=(EditCondition="bIsFluid", ClampMin = 1))
+	uint8 FluidTickInterval = 1;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TSubclassOf<UBlockTickHandler> TickHandler;
+	// Random ticks reach the handler too, scheduled ticks always do
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta=(EditCondition="TickHandler != nullptr"))
+	bool bRandomTicks = false;
 	
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	bool bSideDiffers = false;
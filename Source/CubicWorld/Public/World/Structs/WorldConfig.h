@@ -20,6 +20,12 @@ struct FWorldConfig
 	int32 MaxChunksZ = 4;
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Chunk")
 	uint8 MaxChunkRenderDistance = 16;
+	// Chunks stay loaded this many chunks beyond the load window
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Chunk", meta=(ClampMin = 0))
+	int32 UnloadMargin = 3;
+	// Chunk columns handed to the generator per tick, shared round robin between the trackables
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Chunk", meta=(ClampMin = 1))
+	int32 MaxColumnLoadsPerTick = 16;
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Tiles")
 	FVector BlockSize = FVector(100.0f);
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Tiles")
@@ -29,6 +35,59 @@ struct FWorldConfig
 
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Material")
 	TArray<float> LODs = {1};
+
+	// Milliseconds per tick for each stage of the world manager, 0 is unlimited. Left over work waits for the next tick
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Budgets", meta=(ClampMin = 0.0))
+	float LoadChunksBudget = 1.0f;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Budgets", meta=(ClampMin = 0.0))
+	float GeneratedChunksBudget = 2.0f;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Budgets", meta=(ClampMin = 0.0))
+	float ChunkMeshesBudget = 3.0f;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Budgets", meta=(ClampMin = 0.0))
+	float UnloadChunksBudget = 1.0f;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Rendering")
+	bool bSplitSectionsByDirection = false;
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Rendering", meta=(EditCondition="bSplitSectionsByDirection"))
+	float DirectionCullingMargin = 200.0f;
+	// Hides chunk meshes that can't be reached from the camera through open chunk faces
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Rendering")
+	bool bCaveCulling = false;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Collision")
+	bool bUseSimpleCollision = false;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Collision", meta=(EditCondition="bUseSimpleCollision"))
+	int32 CollisionChunkDistance = 2;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Lighting")
+	bool bBakeLighting = false;
+	// Brightness of a face with light level 0
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Lighting", meta=(EditCondition="bBakeLighting", UIMin = 0.0, UIMax = 1.0))
+	float AmbientLight = 0.05f;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Lighting")
+	bool bBakeAmbientOcclusion = false;
+	// How much a fully occluded corner is darkened
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Lighting", meta=(EditCondition="bBakeAmbientOcclusion", UIMin = 0.0, UIMax = 1.0))
+	float AmbientOcclusionStrength = 0.5f;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Fluids")
+	bool bSimulateFluids = false;
+	// Simulation steps per second
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Fluids", meta=(EditCondition="bSimulateFluids", ClampMin = 1.0))
+	float FluidTickRate = 5.0f;
+	// Limits the work of one step, the rest stays active for the next one
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Fluids", meta=(EditCondition="bSimulateFluids"))
+	int32 MaxFluidCellsPerStep = 4096;
+
+	// Block ticks per second
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Block Ticks", meta=(ClampMin = 1.0))
+	float BlockTickRate = 20.0f;
+	// Blocks picked in every loaded chunk each block tick
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Block Ticks")
+	int32 RandomTicksPerChunk = 3;
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category="Block Ticks")
+	int32 RandomTickSeed = 0;
 	
 	uint16 GetWorldBlockHeight() const
 	{
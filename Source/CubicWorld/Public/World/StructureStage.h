@@ -0,0 +1,48 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GeneratorStage.h"
+#include "StructureStage.generated.h"
+
+/**
+ * Places at most one structure per square region of columns on the surface.
+ * The region seeds its own random stream and every chunk the structure reaches builds it again and keeps its own blocks,
+ * so nothing is written across chunks and a structure is the same whichever chunk is generated first, in any session.
+ * Overlapping structures resolve in region order. Structure block types must not be part of the terrain,
+ * and later stages must not change the ground since a neighbor may already have run them.
+ */
+UCLASS(Abstract)
+class CUBICWORLD_API UStructureStage : public UGeneratorStage
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 Seed = 1340;
+	// Width of a region in blocks
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ClampMin = 1))
+	int32 RegionSize = 8;
+	// Chance of a region to have a structure
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ClampMin = 0.0, ClampMax = 1.0))
+	float Chance = 0.5f;
+	// Only placed on this block type, on any block for UINT8_MAX
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	uint8 GroundBlockTypeId = UINT8_MAX;
+
+	UStructureStage();
+
+	virtual void Generate(const FChunkConfig& ChunkConfig, TChunkData& Blocks, const FGeneratorStageNeighbors& Neighbors) override;
+
+protected:
+	// Blocks in world block coordinates, InOrigin is the air block above the ground. Earlier blocks win over later ones.
+	virtual void PlaceStructure(const FIntVector& InOrigin, FRandomStream& InRandom, TArray<TPair<FIntVector, FBlock>>& OutBlocks) const {}
+	// Furthest a block can be from the origin column in X or Y, at most DependencyRadius chunks
+	virtual int32 GetMaxReach() const { return 0; }
+	// Blocks of this stage, the ground search skips them in neighbors that already ran the stage
+	virtual bool IsStructureBlock(const FBlock& InBlock) const { return false; }
+
+private:
+	// World Z of the topmost terrain block of the world column, INDEX_NONE if there is none or the column is not available
+	int32 FindGround(const FChunkConfig& ChunkConfig, const TChunkData& Blocks, const FGeneratorStageNeighbors& Neighbors, int32 X, int32 Y, FBlock& OutGround) const;
+};
@@ -21,12 +21,35 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	uint8 ChunkRenderDistance = 1;
 
+	// Chunks in the view cone load and mesh before the ones behind
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Streaming")
+	bool bUseViewDirection = true;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Streaming", meta=(EditCondition="bUseViewDirection", UIMin = 0.0, UIMax = 180.0))
+	float ViewConeHalfAngle = 60.0f;
+	// How much further away a chunk behind the view counts
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Streaming", meta=(EditCondition="bUseViewDirection", UIMin = 0.0, UIMax = 4.0))
+	float ViewPriorityWeight = 1.0f;
+
+	// Chunks along the predicted path are generated this many seconds ahead, 0 turns it off
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Streaming", meta=(UIMin = 0.0, UIMax = 10.0))
+	float PrefetchSeconds = 2.0f;
+
 	FIntVector LastWorldPosition;
+	FVector ViewDirection = FVector::ForwardVector;
+	// Smoothed from the movement of the owner, world units per second
+	FVector Velocity = FVector::ZeroVector;
+
+	// Lower is more important, distance in chunks scaled by the view direction
+	float GetChunkPriority(const FVector& InTrackablePosition, const FVector& InChunkPosition) const;
 
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+private:
+	FVector LastLocation;
+	bool bHasLastLocation = false;
+
 public:
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType,
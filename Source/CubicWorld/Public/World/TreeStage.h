@@ -0,0 +1,34 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StructureStage.h"
+#include "TreeStage.generated.h"
+
+/**
+ * Trunk with a ball of leaves on top
+ */
+UCLASS(BlueprintType)
+class CUBICWORLD_API UTreeStage final : public UStructureStage
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	uint8 TrunkBlockTypeId = UINT8_MAX;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	uint8 LeavesBlockTypeId = UINT8_MAX;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ClampMin = 1))
+	int32 MinTrunkHeight = 4;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ClampMin = 1))
+	int32 MaxTrunkHeight = 6;
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(ClampMin = 0, UIMax = 4))
+	int32 LeavesRadius = 2;
+
+	virtual bool ShouldGenerate(const FChunkConfig& ChunkConfig) const override;
+
+protected:
+	virtual void PlaceStructure(const FIntVector& InOrigin, FRandomStream& InRandom, TArray<TPair<FIntVector, FBlock>>& OutBlocks) const override;
+	virtual int32 GetMaxReach() const override;
+	virtual bool IsStructureBlock(const FBlock& InBlock) const override;
+};
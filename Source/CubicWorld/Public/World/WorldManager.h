@@ -4,12 +4,18 @@
 
 #include "CoreMinimal.h"
 #include "Chunk.h"
+#include "BlockTickHandler.h"
+#include "BlockTickScheduler.h"
 #include "ChunkStorage.h"
+#include "FluidSimulation.h"
 #include "Generator.h"
 #include "GeneratorRunner.h"
+#include "InterestManager.h"
+#include "LightEngine.h"
 #include "Trackable.h"
 #include "GameFramework/Actor.h"
 #include "Mesh/ChunkMesh.h"
+#include "Structs/BlockHitResult.h"
 #include "Structs/BlockType.h"
 #include "WorldManager.generated.h"
 
@@ -21,20 +27,29 @@ private:
 	UPROPERTY()
 	UGenerator *Generator;
 	FGeneratorRunner *GeneratorRunner;
+	FInterestManager *InterestManager = nullptr;
+	FLightEngine *LightEngine = nullptr;
+	FFluidSimulation *FluidSimulation = nullptr;
+	FBlockTickScheduler *BlockTickScheduler = nullptr;
+	// Indexed by block type
+	UPROPERTY()
+	TArray<UBlockTickHandler*> BlockTickHandlers;
+	bool bHasRandomTicks = false;
+	TArray<TPair<FIntVector, FBlock>> QueuedBlockChanges;
 	UPROPERTY()
 	UChunkStorage *ChunkStorage;
 
 	UPROPERTY()
 	TMap<FIntVector, UChunk *> Chunks;
 	UPROPERTY()
-	TArray<FIntVector> ModifiedChunks;
+	TSet<FIntVector> ModifiedChunks;
 	UPROPERTY()
 	TMap<FIntVector, AChunkMesh *> ChunkMeshes;
 
 	UPROPERTY()
 	TArray<FIntVector> ChunksToLoad;
 	UPROPERTY()
-	TArray<FIntVector> ChunksToUnload;
+	TSet<FIntVector> ChunksToUnload;
 	UPROPERTY()
 	TSet<FIntVector> VisibleChunks;
 
@@ -61,13 +76,34 @@ protected:
 
 private:
 	FIntVector WorldToLocalPosition(FVector InPosition) const;
+	// No time budget, it only handles columns whose interest changed and at most MaxColumnLoadsPerTick new columns
 	void UpdateVisibleChunks();
+	void UpdatePrefetchChunks();
+	// Most important first for all trackables
+	void SortByChunkPriority(TArray<FIntVector>& InOutChunkPositions) const;
 	void GenerateChunks();
 	void GenerateChunkMeshes();
 	void UnloadChunks();
+	void UpdateChunkMeshSectionVisibility();
+	void UpdateChunkMeshOcclusion();
+	void UpdateChunkMeshCollision();
+	void UpdateLighting();
+	void UpdateFluids(float DeltaTime);
+	void UpdateBlockTicks(float DeltaTime);
 
 	void RemoveBlock(const FIntVector& InChunkPosition, const FIntVector& InBlockPosition);
 
+	FVector WorldToBlockSpace(const FVector& InLocation) const;
+	FVector BlockSpaceToWorld(const FVector& InBlockSpaceLocation) const;
+	FBlock GetLoadedBlock(const FIntVector& InPosition, const UChunk*& InOutChunk, FIntVector& InOutChunkPosition) const;
+	bool IsBlockSolid(const FIntVector& InPosition, const UChunk*& InOutChunk, FIntVector& InOutChunkPosition) const;
+	bool TraceBlocks(const FVector& InStart, const FVector& InEnd, bool bOnlySolid, FBlockHitResult& OutHit) const;
+
+	int32 EditBlocks(const FIntVector& InMin, const FIntVector& InMax, TFunctionRef<bool(const FIntVector&, FBlock&)> InEdit);
+	void MarkChunkDirty(const FIntVector& InChunkPosition, const FIntVector& InChangedMin, const FIntVector& InChangedMax, TSet<FIntVector>& OutDirtyChunks);
+	void EnqueueDirtyChunks(const TSet<FIntVector>& InDirtyChunks);
+	void OnBlockChanged(const FIntVector& InPosition, const FBlock& InOldBlock, const FBlock& InNewBlock);
+
 public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -97,6 +133,51 @@ public:
 	UFUNCTION(BlueprintCallable)
 	FBlock RemoveBlock(const FIntVector& InPosition);
 
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Edit")
+	int32 FillBlocks(const FIntVector& InMin, const FIntVector& InMax, const FBlock& InBlock);
+
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Edit")
+	int32 FillSphere(const FIntVector& InCenter, float InRadius, const FBlock& InBlock);
+
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Edit")
+	int32 ReplaceBlocks(const FIntVector& InMin, const FIntVector& InMax, const FBlock& InFrom, const FBlock& InTo);
+
+	// Sets many blocks at once, grouped by chunk with one remesh per affected chunk
+	int32 ApplyBlockChanges(const TArray<TPair<FIntVector, FBlock>>& InChanges);
+
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Edit")
+	int32 PasteBlocks(const FIntVector& InOrigin, const FIntVector& InSize, const TArray<FBlock>& InBlocks, bool bSkipAir = true);
+
+	// Ticks the block at the position after Delay block ticks if it still has its current type
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Tick")
+	void ScheduleBlockTick(const FIntVector& InPosition, int32 InDelay = 1);
+
+	// Applied with the other queued changes at the end of the block tick, one remesh per chunk
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Tick")
+	void QueueBlockChange(const FIntVector& InPosition, const FBlock& InBlock);
+
+	// Adds fluid to an air or the same fluid block, returns false if the block can't take it
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Fluid")
+	bool AddFluid(const FIntVector& InPosition, const FBlock& InFluid, int32 InLevel = 8);
+
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Fluid")
+	int32 GetFluidLevel(const FIntVector& InPosition) const;
+
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Query")
+	bool IsBlockSolid(const FIntVector& InPosition) const;
+
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Query")
+	bool OverlapBlocks(const FBox& InBox) const;
+
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Query")
+	bool SweepBlocks(const FBox& InBox, const FVector& InDelta, FBlockHitResult& OutHit) const;
+
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Query")
+	bool LineTraceBlocks(const FVector& InStart, const FVector& InEnd, FBlockHitResult& OutHit) const;
+
+	UFUNCTION(BlueprintCallable, Category = "CubicWorld|Query")
+	bool RaycastBlocks(const FVector& InOrigin, const FVector& InDirection, float InMaxDistance, FBlockHitResult& OutHit) const;
+
 	UFUNCTION(BlueprintCallable)
 	bool SaveWorld();
 